@@ -40,7 +40,21 @@
 #include "plot.h"
 #include "rect.h"
 #include "game.h"
+#include "dungen.h"
 #include "dist.h"
+#include "panel.h"
+#include "kbd.h"
+#include "rtc.h"
+#include "sched.h"
+#include "task.h"
+#include "ovl.h"
+#ifdef SFX
+#include "sfx.h"
+#endif
+#include "sound.h"
+#ifdef PROFILE
+#include "prof.h"
+#endif
 
 // skip RAM test
 #define SKIP
@@ -56,43 +70,95 @@ static char getSingleCommand(const char* msg)
 static void startGame()
 {
     uchar v = 1;
-    static char key;
+    uchar ignore = 0xff;
+    char key;
 
     cls();
 
-    while (!generateDungeon()) ;
+    // the generator, from disk or tape after the first game
+    if (!ovlLoad())
+    {
+        outs("Cannot load APSGEN\n");
+        longjmp(main_env, 1);
+    }
+
+    // a layout that fails is tried again, unless RAM is short
+    while (!generateDungeon())
+    {
+        if (generationFailed == fail_no_memory)
+        {
+            outs("Not enough memory\n");
+            longjmp(main_env, 1);
+        }
+    }
 
     TPF("Placing Treasure...\n");
     distributeTreasure(treasures);
 
+    // its RAM is free for play
+    ovlDiscard();
+    initDungeon();
+
+    panelReset();
+
+    // new queue, without keys typed at the prompts
+    kbdInit();
+    kbdNoRepeat("IOADC");
+
+    // timed events, eg. monster moves every MONSTER_MEDIUM ticks
+    schedInit();
+
+    // background work while waiting for keys
+    taskInit();
+    taskAdd(panelTask, 1, 2);
+#ifdef SFX
+    taskAdd(sfxTask, 2, 8);
+#endif
+
     for (;;)
     {
         if (v)
         {
-            renderDungeon();
-            renderPlayer();
-            v = 0;
+            // the frame is abandoned if a newer key is pressed,
+            // it is then redrawn next time round.
+            if (renderDungeonPoll(ignore))
+            {
+                renderPlayer();
+                panelLater();
+                v = 0;
+            }
         }
         
-        key = toupper(scanKeyMatrix(key));
+        schedRun();
+        
+        key = kbdGet();
+        if (!key && !v && !taskRun()) rtcIdle();
+
+        // keys already down do not interrupt the next frame,
+        // except held pan keys, which will just pan again.
+        ignore = keyRows();
 
         switch (key)
         {
         case KEY_ARROW_RIGHT:
             panXY(1,0);
             v = 1;
+            ignore = 0;
             break;
         case KEY_ARROW_LEFT:
             panXY(-1,0);
             v = 1;
+            ignore = 0;
             break;
         case KEY_ARROW_UP:
             panXY(0,-1);
             v = 1;
+            ignore = 0;
             break;
         case KEY_ARROW_DOWN:
             panXY(0,1);
             v = 1;
+            ignore = 0;
             break;
         case 'I':
             zoomIn();
@@ -109,11 +175,29 @@ static void startGame()
             turnRight();
             break;
         case 'W':
-            moveFoward();
+            // only walk on a complete frame, walls are found on screen
+            if (!v)
+            {
+                moveFoward();
+                panelLater();  // eg. new room
+            }
+            break;
+        case 'C':
+            // camera follow on/off
+            if (toggleFollow()) v = 1;
             break;
+#ifdef PROFILE
+        case 'P':
+            if (profKey())
+            {
+                profDump();
+                cls();
+                panelRedraw();
+                v = 1;
+            }
+            break;
+#endif
         }
-
-        if (strchr("IOAD", key)) key = 0;
     }
 }
 
@@ -145,7 +229,16 @@ static void mainloop()
         }
         else
         {
-            char c = getSingleCommand("Play Again? (Y/N)");
+            char c;
+
+            // left the game. its tasks are not for the prompts, where
+            // `getkey' also runs them.
+            taskInit();
+#ifdef SFX
+            sfxStop();
+#endif
+            
+            c = getSingleCommand("Play Again? (Y/N)");
             if (c != 'Y') break;
         }
     }
@@ -154,9 +247,21 @@ static void mainloop()
 int main()
 {
     initModel();
+
+#ifdef COLS80
+    // model specific build on the wrong machine?
+    if ((TRSModel >= 4) != COLS80)
+    {
+        printf_simple("Wrong model, run APSHAI\n");
+        return 0;
+    }
+#endif
+    
+    rtcInit();
     setStack();
     mainloop();
     revertStack();
+    rtcDone();
     
     return 0;   // need this to ensure call to revert (else jp)
 }
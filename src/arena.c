@@ -0,0 +1,96 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include "defs.h"
+#include "os.h"
+#include "arena.h"
+
+#ifdef STANDALONE
+static uchar heapBase[ARENA_HOST];
+#else
+// end of the overlay, see crt0
+extern uchar heapBase[];
+#endif
+
+static uchar* arenaPtr;
+static uchar* arenaTop;
+
+void arenaInit()
+{
+    // after `initModel', for each game (see ovl.h)
+    
+#ifdef STANDALONE
+    arenaTop = heapBase + sizeof(heapBase);
+#else
+    arenaTop = ramTop() - ARENA_STACK;
+#endif
+    arenaPtr = heapBase;
+}
+
+void arenaReset(uchar* base)
+{
+    // empty, now starting at `base', eg. a discarded overlay
+    arenaPtr = base;
+}
+
+uint arenaLeft()
+{
+    return arenaTop > arenaPtr ? arenaTop - arenaPtr : 0;
+}
+
+void* arenaAlloc(uint n)
+{
+    // return 0 if not enough
+    uchar* p = arenaPtr;
+    if (n > arenaLeft()) return 0;
+    arenaPtr += n;
+    return p;
+}
+
+void* arenaCache(uint n, uint keep)
+{
+    // allocate a cache of `n' only if `keep' bytes would be left,
+    // eg. for scratch needed later.
+    uint a = arenaLeft();
+    if (n > a || keep > a - n) return 0;
+    return arenaAlloc(n);
+}
+
+uchar* arenaMark()
+{
+    return arenaPtr;
+}
+
+void arenaRelease(uchar* m)
+{
+    // free everything allocated since `m'
+    arenaPtr = m;
+}
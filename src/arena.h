@@ -0,0 +1,58 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#ifndef __arena_h__
+#define __arena_h__
+
+/* memory arena.
+ *
+ * RAM from the end of BSS up to the stack is handed out in order.
+ * during play the arena also has the RAM of the overlay (see ovl.h).
+ * Scratch can be given back with `arenaMark' and `arenaRelease'.
+ * Caches are optional and only allocated if enough RAM would remain,
+ * so a 16K machine runs without them and bigger machines get them.
+ */
+
+// room for the stack below `ramTop'
+#define ARENA_STACK     1536
+
+// arena of the host build
+#define ARENA_HOST      0x8000
+
+void arenaInit();
+void arenaReset(uchar* base);
+uint arenaLeft();
+void* arenaAlloc(uint n);
+void* arenaCache(uint n, uint keep);
+uchar* arenaMark();
+void arenaRelease(uchar* m);
+
+#endif // __arena_h__
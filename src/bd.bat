@@ -1,2 +1,2 @@
-cl /Ox -DSTANDALONE dungeon.c rect.c
+cl /Ox -DSTANDALONE dungeon.c dungen.c rect.c plot.c sprite.c panel.c rand.c fastmath.c arena.c file.c host.c
 
@@ -1 +1 @@
-cl /Zi -DSTANDALONE dist.c
+cl /Zi -DSTANDALONE dist.c rand.c fastmath.c
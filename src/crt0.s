@@ -59,7 +59,10 @@ init:
 	.area	_DATA
     .area	_INITIALIZED
 	.area   _BSS
+	.area   _GEN                    ; --codeseg _GEN, see makefile
+_genBase::                      ; overlay, see ovl.c
 	.area   _HEAP
+_heapBase::                     ; end of the overlay, see arena.c
 
 	.area   _CODE
 
@@ -43,8 +43,14 @@ typedef uchar BOOL;
 #define FALSE 0
 
 // 16 bitints
+#ifdef STANDALONE
+#include <stdint.h>
+typedef uint16_t uint16;
+typedef int16_t int16;
+#else
 typedef unsigned int uint16;
 typedef int int16;
+#endif
 
 #define VIDRAM ((char*)0x3c00)
 #define VIDSIZE 1024
@@ -52,6 +58,16 @@ typedef int int16;
 #define VIDRAM80 ((char*)0xf800)
 #define VIDSIZE80 (80*24)
 
+// model specific builds fix the screen geometry at compile time,
+// eg. -DMODEL=4 (see makefile). otherwise `cols80' is set by `initModel'.
+#if defined(MODEL)
+#if MODEL >= 4
+#define COLS80  1
+#else
+#define COLS80  0
+#endif
+#endif
+
 #define HIGH48K ((char*)0xFFFF)
 #define HIGH32K 0xBFFF
 #define HIGH16K 0x7FFF
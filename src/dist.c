@@ -35,37 +35,14 @@
 #include "rect.h"
 #include "game.h"
 #include "dist.h"
+#include "rand.h"
 
 #ifdef STANDALONE
 
 #include <assert.h>
 #include <stdio.h>
-#include <stdint.h>
 
-static uint64_t _seed = 4101842887655102017LL;
-
-static void seed(const uint64_t s)
-{
-    _seed ^= s;
-}
-
-static unsigned int random()
-{
-    _seed ^= _seed >> 21;
-    _seed ^= _seed << 35;
-    _seed ^= _seed >> 4;
-    return _seed*2685821657736338717LL;
-}
-
-static unsigned int randc(unsigned int n)
-{
-    return random() % n;
-}
-
-static unsigned int randn(unsigned int n)
-{
-    return random() % n;
-}
+int verbose = 1;
 
 // dummy
 uchar roomCount, corridorCount;
@@ -100,7 +77,7 @@ void distributeTreasure(Treasure* tr)
     for (i = 1; i < roomCount; ++i)
     {
         // don't place in corridor
-        mark[i] = (rooms[i].flags & room_corridor);
+        mark[i] = roomIsCorridor(rooms + i);
     }
 
     DPF1(verbose, "distribute treasures into %d rooms\n", roomCount - corridorCount);
@@ -132,7 +109,6 @@ void distributeTreasure(Treasure* tr)
         do
         {
             tr->id = (best - treasureGen) + BASE_ID_TREASURE;
-            tr->gen = best;
             
             DPF3(verbose, "Allocating T%d, '%s' (%d); ", tr->id, best->name, best->value);
 
@@ -228,7 +204,7 @@ void distributeTreasure(Treasure* tr)
 
 int main(int argc, char** argv)
 {
-    seed(time(0));
+    srand(time(0));
 
     int i;
     for (i = 1; i < argc; ++i)
@@ -258,7 +234,7 @@ int main(int argc, char** argv)
     for (i = 0; i < roomCount; ++i)
     {
         int v = randc(2);
-        rooms[i].flags = v;
+        rooms[i].nf = v ? room_corridor : room_normal;
         corridorCount += v;
         if (roomCount - corridorCount - 1 <= tcount) break; 
     }
@@ -0,0 +1,133 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#ifndef __dungen_h__
+#define __dungen_h__
+
+/* shared by the renderer, `dungeon.c' and the generator, `dungen.c'.
+ * the generator is an overlay (see ovl.h), so nothing resident may
+ * call into it other than `generateDungeon' at the start of a game.
+ */
+
+#ifdef STANDALONE
+
+extern int halt;
+extern int unicode;
+
+// error print
+#define EPF(_c, _x)  { if (_c) { printf(_x); halt=1;} }
+#define EPF1(_c, _x, _a)  { if (_c) { printf(_x, _a); halt=1; } }
+#define EPF2(_c, _x, _a, _b)  { if (_c) { printf(_x, _a, _b); halt=1; } }
+
+void printDungeon();
+
+#else
+
+#define EPF(_c, _x)
+#define EPF1(_c, _x, _a)
+#define EPF2(_c, _x, _a, _b)
+
+#endif // STANDALONE
+
+#define SMALL
+#define DUN_WBITS 6U
+#define DUN_WIDTH  (1<<DUN_WBITS)
+#define DUN_HEIGHT 48
+#define DUN_TILES  (DUN_WIDTH*DUN_HEIGHT)
+
+// if all were rooms, this can be exceeded
+#define MAX_EXITS ((NUM_FEATUES+1)*3+2)
+
+#ifdef SMALL
+typedef signed char Int;
+typedef unsigned char Uint;
+#else
+typedef int Int;
+typedef unsigned int Uint;
+#endif
+
+enum Tile
+	{
+		Unused		= 0,
+		Floor		= ' ',
+		ClosedDoor	= '+',
+		UpStairs	= '<',
+		DownStairs	= '>'
+	};
+
+enum FailCode
+    {
+        fail_void = 0,
+        fail_max_room_exits = 1,
+        fail_max_exits = 2,
+        fail_no_memory = 3,     // no tile grid, another try is no better
+    };
+
+typedef struct
+{
+    Uint u;
+    Uint v1;
+    Uint v2;
+} VHLine;
+
+// walls are split at junctions so that each belongs to the sides
+// of the rooms it bounds.
+#define MAX_HLINES  ((NUM_FEATUES*4)+10)
+#define MAX_VLINES  ((NUM_FEATUES*4)+10)
+
+// each wall is on the side of one or two rooms
+#define MAX_ROOM_WALLS  (((MAX_HLINES + MAX_VLINES)*3)/2)
+
+// x8 is max scale. this must be a whole number as positions
+// are stored in its pixels.
+#define MAX_SCALEBITS   3
+#define MAX_SCALE       (1<<MAX_SCALEBITS)
+
+extern Uint exitCount;
+extern Uint generationFailed;
+
+// coordinates are stored 2x, 2y
+extern VHLine hlines[];
+extern VHLine vlines[];
+extern Uint hlineCount;
+extern Uint vlineCount;
+
+// room i has hlines roomWalls[wallStart[i]..wallSplit[i]-1]
+// and vlines roomWalls[wallSplit[i]..wallStart[i+1]-1]
+extern uchar roomWalls[];
+extern uint wallStart[];
+extern uint wallSplit[];
+
+// resident, used by both
+Uint findRoom(Uint x, Uint y);
+Int getConnectedRoom(Uint ri, Uint ei);
+
+#endif // __dungen_h__
@@ -34,8 +34,8 @@
  * size, eg 64x48 and these cells correspond to pixels accoring to (2x, y),
  * so that the map would fill a 128x48 screen at unit scale.
  *
- * When zoomed in the scale is 2x, 4x, 8x. Of course now only part of the
- * dungeon is visible and will be clipped accordingly. 
+ * When zoomed in the scale is 1.5x, 2x, 3x, 4x, 6x, 8x. Of course now only
+ * part of the dungeon is visible and will be clipped accordingly. 
  */
 
 #include "defs.h"
@@ -43,144 +43,31 @@
 #include "rect.h"
 #include "utils.h"
 #include "game.h"
+#include "os.h"
+#include "plot.h"
+#include "sprite.h"
+#include "panel.h"
+#include "kbd.h"
+#include "rand.h"
+#include "arena.h"
+#include "fastmath.h"
+
+#include "dungen.h"
 
 #ifdef STANDALONE
 
+// host build, see host.c
 #include <assert.h>
 #include <stdio.h>
-#include <stdint.h>
+#include <stdlib.h>
 #include <time.h>
+#include "host.h"
 
-static int halt = 0;
-
-// error print
-#define EPF(_c, _x)  { if (_c) { printf(_x); halt=1;} }
-#define EPF1(_c, _x, _a)  { if (_c) { printf(_x, _a); halt=1; } }
-#define EPF2(_c, _x, _a, _b)  { if (_c) { printf(_x, _a, _b); halt=1; } }
-
-
-static uint64_t _seed = 4101842887655102017LL;
-
-static void seed(const uint64_t s)
-{
-    _seed ^= s;
-}
-
-static unsigned int random()
-{
-    _seed ^= _seed >> 21;
-    _seed ^= _seed << 35;
-    _seed ^= _seed >> 4;
-    return _seed*2685821657736338717LL;
-}
-
-static unsigned int randc(unsigned int n)
-{
-    return random() % n;
-}
-
-#else
-
-#include "os.h"
-#include "plot.h"
-
-#define EPF(_c, _x)
-#define EPF1(_c, _x, _a)
-#define EPF2(_c, _x, _a, _b)
+int halt = 0;
+int verbose = 1;
 
 #endif // STANDALONE
 
-#define SMALL
-#define DUN_WBITS 6U
-#define DUN_WIDTH  (1<<DUN_WBITS)
-#define DUN_HEIGHT 48
-
-#define minRoomSizeX 4
-#define maxRoomSizeX 6
-#define minRoomSizeY 4
-#define maxRoomSizeY 7
-
-#define minCorridorLength 4
-#define maxCorridorLength 7
-#define maxCorridorConnect 10
-
-// of 128
-#define roomChance 64
-
-// if all were rooms, this can be exceeded
-#define MAX_EXITS ((NUM_FEATUES+1)*3+2)
-
-
-#ifdef SMALL
-typedef signed char Int;
-typedef unsigned char Uint;
-#else
-typedef int Int;
-typedef unsigned int Uint;
-#endif
-
-static Uint randomInt(Uint a, Uint b)
-{
-    // random x, a <= x <= b
-    return randc(b - a + 1) + a;
-}
- 
-#define SET_TILE(_x, _y, _c) _tiles[(_x) + ((_y) << DUN_WBITS)] = (_c)
-#define GET_TILE(_x, _y) _tiles[(_x) + ((_y) << DUN_WBITS)]
-
-// when x, y is 2x, 2y
-#define GET_TILE2(_x, _y) _tiles[((_x)>>1) + ((_y) << (DUN_WBITS-1))]
-
-#define TILE_BASE(_x, _y) (_tiles + (_x) + ((_y) << DUN_WBITS))
-
-
-#define EXIT_IS_FINAL(_e) ((_e).flags & 1)
-#define EXIT_SET_FINAL(_e) ((_e).flags |= 1)
-
-typedef struct
-{
-    // entry
-    Uint x;
-    Uint y;
-    Int d;
-
-    Rect r;
-    
-    Uint w;
-    Uint h;
-    Uint len;
-
-    // exit
-    Uint ox;
-    Uint oy;
-
-    Uint room;
-    
-} Ent;
-
-enum Tile
-	{
-		Unused		= 0,
-		Floor		= ' ',
-		ClosedDoor	= '+',
-		UpStairs	= '<',
-		DownStairs	= '>'
-	};
-
-enum FailCode
-    {
-        fail_void = 0,
-        fail_max_room_exits = 1,
-        fail_max_exits = 2,
-    };
-
-
-// these are valid during generation
-static unsigned char* _tiles;
-
-static Uint generationFailed;
-
-
 Uint roomCount; // rooms+corridors
 Uint corridorCount;
 Room rooms[MAX_ROOMS];  // valid after generation
@@ -189,91 +76,74 @@ Treasure treasures[MAX_TREASURES];
 Uint exitCount;
 Exit exits[MAX_EXITS];
 
-typedef struct
-{
-    Uint u;
-    Uint v1;
-    Uint v2;
-} VHLine;
+// zoom factors, 8.8 fixed point
+static const uint zoomFactors[] = { 0x100, 0x180, 0x200, 0x300, 0x400, 0x600, 0x800 };
+#define MAX_ZOOM    6
 
-#define MAX_HLINES  ((NUM_FEATUES*2)+10)
-#define MAX_VLINES  ((NUM_FEATUES*2)+10)
+// levels the map cache can hold
+#define ZOOM_1X     0
+#define ZOOM_2X     2
 
-// x8 is max scale
-#define MAX_SCALEBITS 3
-
-// coordinates are stored 2x, 2y
-static VHLine hlines[MAX_HLINES];
-static VHLine vlines[MAX_VLINES];
-static Uint hlineCount;
-static Uint vlineCount;
+// made by the generator
+VHLine hlines[MAX_HLINES];
+VHLine vlines[MAX_VLINES];
+Uint hlineCount;
+Uint vlineCount;
+uchar roomWalls[MAX_ROOM_WALLS];
+uint wallStart[MAX_ROOMS+1];
+uint wallSplit[MAX_ROOMS];
 
 // top left of viewport
 static int viewx;
 static int viewy;
-static Uint scalebits;
-static Uint entranceRoom;
+static Uint zoom;
+
+// pixel of each 2x and 2y map coordinate at the current zoom
+static int scaleX[DUN_WIDTH*2+1];
+static int scaleY[DUN_HEIGHT*2+1];
 
 Player player;
 
 #define VIEW_W  128
 #define VIEW_H  48
 
+// view width in pixels, narrower on 64 columns to make room for the panel
+static uchar viewW = VIEW_W;
 
-static void move(Ent* e)
-{
-    Int d = e->d;
-    
-    if (d & North)
-    {
-        if (!e->r.y1) return;
-        --e->r.y1;
-    }
-    if (d & East)
-    {
-        if (e->r.x1 == DUN_WIDTH) return;
-        ++e->r.x1;
-    }
-    if (d & South)
-    {
-        if (e->r.y1 == DUN_HEIGHT) return;
-        ++e->r.y1;
-    }
-    if (d & West)
-    {
-        if (!e->r.x1) return;
-        --e->r.x1;
-    }
-}
+#define SPRITE_REACH    3
 
-static BOOL checkRect(Ent* e)
-{
-    // also check for unsigned wrap-around
+// zoom 1x and 2x can be pre-rendered, 64x16 and 128x32 cells.
+// the 2x image is first, then 1x.
+#define MAPCACHE_W1     128
+#define MAPCACHE_H1     32
 
-    unsigned char* tp;
-    Uint dy;
+// fixed 80 column builds cannot drop to 64 columns to render a tile,
+// so it is rendered at 80 and packed.
+#if COLS80
+#define TILE_STRIDE     80
+#else
+#define TILE_STRIDE     64
+#endif
 
-    if (e->r.x1 <= 0 || e->r.y1 <= 0 || e->r.x2 >= DUN_WIDTH || e->r.y2 >= DUN_HEIGHT) return FALSE;
-    
-    tp = TILE_BASE(e->r.x1, e->r.y1);
-    dy = e->h;
-    while (dy)
-    {
-        unsigned char* t1 = tp;
-        Uint dx = e->w;
-        while (dx)
-        {
-            --dx;
-            if (*t1++) return FALSE; // used
-        }
-        tp += DUN_WIDTH;
-        --dy;
-    }
+#define MAPCACHE_SIZE   (MAPCACHE_W1*MAPCACHE_H1 + TILE_STRIDE*MAPCACHE_H1/2)
+
+static uchar* mapCache;  // 0 if not enough RAM
+static uchar mapCacheValid;
+
+// camera follow at max zoom. the view moves only when the player
+// leaves the middle half of the view, then by half a view so the
+// player lands on the far side of the dead zone.
+#define FOLLOW_X1       (viewW/4)
+#define FOLLOW_X2       (viewW - viewW/4)
+#define FOLLOW_Y1       (VIEW_H/4)
+#define FOLLOW_Y2       (VIEW_H - VIEW_H/4)
+#define FOLLOW_STEPX    (viewW/2)
+#define FOLLOW_STEPY    (VIEW_H/2)
+
+static uchar follow = TRUE;
 
-    return TRUE;
-}
 
-static Uint findRoom(Uint x, Uint y)
+Uint findRoom(Uint x, Uint y)
 {
     // return 1-based room index, 0 for fail
     
@@ -285,7 +155,7 @@ static Uint findRoom(Uint x, Uint y)
     return 0;
 }
 
-static Int getConnectedRoom(Uint ri, Uint ei)
+Int getConnectedRoom(Uint ri, Uint ei)
 {
     // ri is 1-based room index
     // ei is 0-based exit index
@@ -305,516 +175,66 @@ static Int getConnectedRoom(Uint ri, Uint ei)
         
         Exit* ep = exits + (e - 1);
         
-        if (ep->room == ri) r = ep->otherroom;
-        else if (ep->otherroom == ri) r = ep->room;
+        if (exitRoom(ep) == ri) r = exitOther(ep);
+        else if (exitOther(ep) == ri) r = exitRoom(ep);
         
-        EPF1(r < 0, "Room has no other %d\n", rooms[ri-1].no);
+        EPF1(r < 0, "Room has no other %d\n", roomNo(rooms + (ri-1)));
         
     }
     return r;
 }
 
-static BOOL roomsConnected(Uint ra, Uint rb)
-{
-    // is room `ra` connected to room `rb` ?
-    // ra is 1-based room index
-    // rb is 1-based room index
-
-    Int i;
-    for (i = 0; i < MAX_ROOM_EXITS; ++i)
-    {
-        Int j = getConnectedRoom(ra, i); // NB: can return 0
-        if (j < 0) break;
-        if (j == (Int)rb) return TRUE;
-    }
-    return FALSE;
-}
-
-static void labelByDistance(Uint r1)
-{
-    // r1 = 1-based index of room1
-
-    Uint rstack[MAX_ROOMS];
-    Uint top = 0;
-    Uint bot = 0;
-    rstack[bot++] = r1;
-
-    while (top != bot)
-    {
-        Uint r = rstack[top++];
-        Uint i;
-
-        rooms[r-1].no = top; // start at 1
-        
-        for (i = 0; i < MAX_ROOM_EXITS; ++i)
-        {
-            Int j = getConnectedRoom(r, i);
-            if (j < 0) break;
-
-            Uint k;
-            for (k = 0; j > 0 && k < bot; ++k)
-            {
-                if ((Int)rstack[k] == j) j = -1; // already listed
-            }
-
-            if (j > 0)
-            {
-                rstack[bot++] = j;
-            }
-        }
-    }
-}
-
-static BOOL spontaneousExit2(Ent* e, Uint room1)
-{
-    BOOL v;
-    
-    e->r.x1 = e->x;
-    e->r.y1 = e->y;
-
-    move(e);
-    v = (GET_TILE(e->r.x1, e->r.y1) == Floor);
-    if (v)
-    {
-        Uint room2 = findRoom(e->r.x1, e->r.y1);
-        v = room2 && !roomsConnected(room1, room2);
-
-        if (v)
-        {
-            //DPF2(verbose, "spontaneous exit rooms %d->%d\n", room1, room2);
-            e->room = room2;
-        }
-    }
-        
-    return v;
-}
-
-#if 0
-static Uint scan(Ent* e, Uint v)
-{
-    Uint t;
-        
-    e->r.x1 = e->x;
-    e->r.y1 = e->y;
-
-    for (;;)
-    {
-        t = GET_TILE(e->r.x1, e->r.y1);
-        if (t != v) break;
-        if (!move(e)) break;
-    }
-    return t;
-}
-    
-static BOOL spontaneousExit(Ent* e)
-{
-    BOOL v;
-    
-    e->r.x1 = e->x;
-    e->r.y1 = e->y;
-
-    move(e);
-    v = (GET_TILE(e->r.x1, e->r.y1) == Floor);
-    if (v)
-    {
-        Uint t;
-        Ent e2;
-        e2.x = e->x;
-        e2.y = e->y;
-
-        t = GET_TILE(e2.x, e2.y);
-        if (t == (East|West))
-        {
-            e2.d = East;
-            v = (scan(&e2, East|West) != ClosedDoor);
-            if (v)
-            {
-                e2.d = West;
-                v = (scan(&e2, East|West) != ClosedDoor); 
-            }
-        }
-        else if (t == (North|South))
-        {
-            e2.d = North;
-            v = (scan(&e2, North|South) != ClosedDoor);
-            if (v)
-            {
-                e2.d = South;
-                v = (scan(&e2, North|South) != ClosedDoor); 
-            }
-        }
-        else
-        {
-            //if (t != ClosedDoor) printf("no exit from '%c' %02X at %d,%d,%d\n", (char)t, t, e->x, e->y, e->d);
-
-            assert(t == ClosedDoor);
-            v = FALSE;
-        }
-    }
-
-    if (v)
-    {
-        e->room = findRoom(e->r.x1, e->r.y1);
-        DPF(verbose && !e->room, "Cannot find spontaneous exit room\n");
-
-        //DPF1(verbose, "spontaneous exit room %d\n", e->room);
-    }
-        
-    return v;
-}
-#endif
-
-
-static void addExit(Uint x, Uint y, Int d)
-{
-    if (exitCount == MAX_EXITS)
-    {
-        generationFailed = fail_max_exits;
-    }
-    else
-    {
-        Exit* e = exits + exitCount++;
-        e->x = x;
-        e->y = y;
-        e->d = d;
-        e->flags = 0;
-
-        // when we add an exit, we have just placed a room or a corridor
-        // and roomCount is currently valid.
-        e->room = roomCount; // index into rooms array+1 (1-based)
-        e->otherroom = 0;
-    }
-}
-
-static void addExitX(Ent* e, Uint y, Int d)
-{
-    addExit(e->r.x1 + randc(e->w-2) + 2, y, d);    
-}
-
-static void addExitY(Ent* e, Uint x, Int d)
-{
-    addExit(x, e->r.y1 + randc(e->h-2) + 2, d);
-}
-
-static void addRoom(Ent* e, uchar flags)
-{
-    // keep track of the boxes for each room or corridor
-    // these will need to be scaled up as usual
-    Room* rp = rooms + roomCount;
-    memset(rp, 0, sizeof(Room));
-    rp->r = e->r;
-    rp->flags = flags;
-    e->room = ++roomCount; // 1-based
-}
-
-static void placeRect(Ent* e, uchar flags)
-{
-    // assume Already checked
-    unsigned char* t1;
-    unsigned char* t2;
-    unsigned char* t3;
-    Uint x, y;
-
-    addRoom(e, flags);
-
-    // expand up and back so we can paint the border
-    --e->r.x1;
-    --e->r.y1;
-    
-    t1 = TILE_BASE(e->r.x1, e->r.y1);
-    t3 = t1;
-    
-    // top left
-    *t1++ |= South|East;
-
-    // top right
-    t1[e->w] |= South|West;
-
-    t2 = TILE_BASE(e->r.x1, e->r.y2);
-
-    // bottom left
-    *t2++ |= North|East;
-
-    // bottom right
-    t2[e->w] |= North|West;
-
-    // top and bottom h-walls
-    x = e->w;
-    while (x)
-    {
-        --x;
-        *t1++ |= East|West;
-        *t2++ |= East|West;
-    }
-
-    t1 = t3;
-    y = e->h;
-    while (y)
-    {
-        --y;
-
-        t1 += DUN_WIDTH;
-        t2 = t1;
-
-        // left v-wall
-        *t2++ |= North|South;
-
-        // inside floor
-        x = e->w;
-        while (x)
-        {
-            --x;
-            *t2++ = Floor;
-        }
-
-        // right v-wall
-        *t2 |= North|South;
-    }
-}
-
-static void setRoomBox(Ent* e)
-{
-    // NB: dir can be Void
-
-    Uint w = e->w;
-    Uint h = e->h;
-    Uint d = e->d;
-
-    e->r.x1 = e->x;
-    e->r.y1 = e->y;
-
-    if (d & (North | South))
-    {
-        e->r.x1 -= w>>1;
-
-        if (d == North) e->r.y1 -= h;
-        else ++e->r.y1; // south
-    }
-
-    if (d & (East | West))
-    {
-        e->r.y1 -= h>>1;
-
-        if (d == East) ++e->r.x1;
-        else e->r.x1 -= w; // west
-    }
-        
-    e->r.x2 = e->r.x1 + w;
-    e->r.y2 = e->r.y1 + h;
-}
-    
-static BOOL checkRoom(Ent* e)
-{
-    setRoomBox(e);
-    return checkRect(e);
-}
-
-static void placeRoom(Ent* e)
-{
-    // assume already checked
-        
-    placeRect(e, room_normal);
-
-    if (e->d != South) // north side
-        addExitX(e, e->r.y1, North);
-    if (e->d != North) // south side
-        addExitX(e, e->r.y2, South);
-    if (e->d != East) // west side
-        addExitY(e, e->r.x1, West);
-    if (e->d != West) // east side
-        addExitY(e, e->r.x2, East);
-}
-    
-static BOOL randomRoom(Ent* e)
-{
-    BOOL v;
-    e->w = randomInt(minRoomSizeX, maxRoomSizeX);
-    e->h = randomInt(minRoomSizeY, maxRoomSizeY);
-    v = checkRoom(e);
-    if (v) placeRoom(e);
-    return v;
-}
-
-static void setCorridorBox(Ent* e)
-{
-    e->r.x1 = e->ox = e->x;
-    e->r.y1 = e->oy = e->y;
-
-    e->r.x2 = e->r.x1 + 1;
-    e->r.y2 = e->r.y1 + 1;
-
-    if (e->d == North)
-    {
-        e->r.y2 = e->r.y1;
-        e->r.y1 -= e->len;
-        e->oy = e->r.y1 - 1;
-    }
-    else if (e->d == East)
-    {
-        ++e->r.x1;
-        e->r.x2 += e->len;
-        e->ox = e->r.x2;
-    }
-    else if (e->d == South)
-    {
-        ++e->r.y1;
-        e->r.y2 += e->len;
-        e->oy = e->r.y2;
-    }
-    else // if (dir == West)
-    {
-        e->r.x2 = e->r.x1;
-        e->r.x1 -= e->len;
-        e->ox = e->r.x1 - 1;
-    }
-
-    e->w = e->r.x2 - e->r.x1;
-    e->h = e->r.y2 - e->r.y1;
-}
-    
-static Int checkCorridor(Ent* e)
-{
-    // cant fit or bad hit -1
-    // ok 0
-    // >0, hit but ok
-
-    Uint t;
-
-    setCorridorBox(e);
-        
-    // use bigger margin to avoid edges
-    if (!checkRect(e)) return -1; // fail
-
-    t = GET_TILE(e->ox, e->oy);
-
-    // hit non-wall (eg corner?)
-    if (t && t != (North|South) && t != (East|West)) return -1;
-
-    // return 0 if nothing at end
-    // return edge code if hit something
-    return t;
-}
-
-static void placeCorridor(Ent* e)
-{
-    // assume already checked
-        
-    placeRect(e, room_corridor);
-    addExit(e->ox, e->oy, -e->d);
-
-    ++corridorCount;
-}
+// -1 => above
+// +1 => below
+static Int clip;
+//static Int clipx;
+//static Int clipy;
 
-static BOOL randomCorridor(Ent* e)
+static void setScale(Uint z)
 {
-    // find longest corridor
-    Int c = 0;
+    // make the scale tables for zoom level `z' by repeated addition
     
-    for (e->len = minCorridorLength; e->len <= maxCorridorConnect; ++e->len)
-    {
-        c = checkCorridor(e);
-        if (c) break;
-    }
+    uint f = zoomFactors[z];
+    uint frac;
+    int v;
+    Uint i;
 
-    if (e->len <= minCorridorLength) return FALSE;
+    zoom = z;
 
-    if (c > 0 && e->len <= maxCorridorConnect)
+    // x is 2x, so it is just x*f.
+    // walls are drawn in whole characters, so keep x even unless 1x,
+    // which is all the powers of two anyway.
+    v = 0;
+    frac = 0;
+    for (i = 0; i <= DUN_WIDTH*2; ++i)
     {
-        // corridor abuts to object
-        // placeCorridor(e);
+        scaleX[i] = z ? (v & ~1) : v;
+        frac += f & 0xff;
+        v += (f >> 8) + (frac >> 8);
+        frac &= 0xff;
     }
-    else
-    {
-        // len-1 >= minCorridorLength, was OK
-
-        Uint i;
-        Uint l = e->len-1;
-        if (l > maxCorridorLength) l = maxCorridorLength;
-            
-        // try to place a random room on end. try a few times
-        for (i = 0; i < 3; ++i)
-        {
-            Ent r;
-                        
-            e->len = randomInt(minCorridorLength, l);
-            setCorridorBox(e);
-
-            // can we fit a room here?
-            r.x = e->ox;
-            r.y = e->oy;
-            r.d = e->d;
-                
-            if (randomRoom(&r)) break;
-        }
-
-        if (i == 3) return FALSE; // failed to make a corridor
-    }
-        
-    placeCorridor(e); 
-    return TRUE;
-}
-
-static Uint dist(Exit* e, Uint x, Uint y)
-{
-    Int dx = e->x - x;
-    if (dx < 0) dx = -dx;
-    Int dy = e->y - y;
-    if (dy < 0) dy = -dy;
-    return dx + dy - ((dx>dy ? dy : dx)>>1);
-}
 
-static void addRoomExit(Exit* e, Uint room)
-{
-    // this can fail if we do not have enough space to add
-    // another exit.
-    if (room)
+    // the scaling needs to include a 0.5 factor so that the lines
+    // can be conceptually mid pixel.
+    // y is 2y, so floor((y+1)*f/2), except 1x reduces to floor(y/2)
+    f >>= 1;
+    v = 0;
+    frac = 0;
+    if (z)
     {
-        Room* r = rooms + (room - 1);
-        uchar* re = r->exits;
-        Uint i = MAX_ROOM_EXITS;
-        while (i > 0 && *re) { --i; ++re; }
-        if (i)
-            *re = (e - exits) + 1; // NB: divide!!  1-based
-        else
-        {
-            generationFailed = fail_max_room_exits;
-        }
+        v = f >> 8;
+        frac = f & 0xff;
     }
-}
-
-static void set_exit_door(Exit* e, Uint otherroom)
-{
-    // can set generationFailed
     
-    EXIT_SET_FINAL(*e);
-    SET_TILE(e->x, e->y, ClosedDoor);
-
-    //DPF2(verbose, "exit from room %d to %d\n", e->room, otherroom);
-
-    addRoomExit(e, e->room);
-
-    if (otherroom)
+    for (i = 0; i <= DUN_HEIGHT*2; ++i)
     {
-        EPF2(e->otherroom, "exit has already other room %d, trying to add %d\n", e->otherroom, otherroom);
-
-        e->otherroom = otherroom;
-        addRoomExit(e, otherroom);
+        scaleY[i] = v;
+        frac += f & 0xff;
+        v += (f >> 8) + (frac >> 8);
+        frac &= 0xff;
     }
 }
 
-// -1 => above
-// +1 => below
-static Int clip;
-//static Int clipx;
-//static Int clipy;
-
-static void scaleCoordMax(Coord* c)
-{
-    // scale coordinates to highest res
-    c->y = (c->y << MAX_SCALEBITS) + (1<<(MAX_SCALEBITS-1));
-    c->x <<= MAX_SCALEBITS+1;
-}
-
 static Int clipCoord(Coord* c)
 {
     Int cl = 0;
@@ -826,10 +246,10 @@ static Int clipCoord(Coord* c)
         cl = -1;
         v = 0;
     }
-    else if (v > VIEW_W-1)
+    else if (v > viewW-1)
     {
         cl = 1;
-        v = VIEW_W-1;
+        v = viewW-1;
     }
     c->x = v;
 
@@ -848,6 +268,49 @@ static Int clipCoord(Coord* c)
     return cl;
 }
 
+// floor(d*r/MAX_SCALE), the pixels `r' of MAX_SCALE along a step of
+// `d' pixels. steps below MAX_ZOOM are at most 6 pixels.
+static const uchar subPixel[8][MAX_SCALE] =
+{
+    { 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 0, 0, 1, 1, 1, 1 },
+    { 0, 0, 0, 1, 1, 1, 2, 2 },
+    { 0, 0, 1, 1, 2, 2, 3, 3 },
+    { 0, 0, 1, 1, 2, 3, 3, 4 },
+    { 0, 0, 1, 2, 3, 3, 4, 5 },
+    { 0, 0, 1, 2, 3, 4, 5, 6 },
+};
+
+static void levelCoord(Coord* c)
+{
+    // a position, kept in MAX_ZOOM pixels, to pixels of the current
+    // level. between two entries of `scaleX' or `scaleY' a position
+    // goes the same fraction of the way, by `subPixel'.
+
+    uint i;
+    uchar r;
+
+    if (zoom == MAX_ZOOM) return;
+
+    // x is 2x, MAX_SCALE pixels each
+    i = ((uint)c->x) >> MAX_SCALEBITS;
+    r = c->x & (MAX_SCALE-1);
+    c->x = scaleX[i] + subPixel[scaleX[i+1] - scaleX[i]][r];
+
+    // y is 2y from half a cell down, MAX_SCALE/2 pixels each
+    i = ((uint)c->y - MAX_SCALE/2) >> (MAX_SCALEBITS-1);
+    r = (c->y - MAX_SCALE/2) & (MAX_SCALE/2-1);
+    c->y = scaleY[i] + subPixel[scaleY[i+1] - scaleY[i]][r << 1];
+}
+
+static Uint roomAt(const Coord* c)
+{
+    // the room at a position, from its cell whatever the level shown.
+    // in a doorway, there is none.
+    return findRoom(((uint)c->x)/(MAX_SCALE*2), ((uint)c->y)/MAX_SCALE);
+}
+
 static Uint scaleClipX(Uint x)
 {
     // NB: x is 2x
@@ -857,27 +320,20 @@ static Uint scaleClipX(Uint x)
     
     clip = 0;
 
-    // the scaling needs to include a 0.5 factor so that the lines
-    // can be conceptually mid pixel.
-    // here we scale x additionally *2, compared to y
-
-    // floor((x+0.5)*2^(scalebits+1)) - floor(0.5*2^(scalebits+1))
-    // = (2x+1)*2^scalebits  - 2^scalebits
-    // = 2x * 2^scalebits
-
-    x1 = (((int)x)<<scalebits) - viewx;
+    // see `setScale'
+    x1 = scaleX[x] - viewx;
 
     if (x1 < 0)
     {
         clip = -1;
         return 0;
     }
-    if (x1 >= VIEW_W-1)
+    if (x1 >= viewW-1)
     {
         // NB: clip at width-1, because we are going to draw double vlines.
         // we allow max of W-1 to be included in plot.
         clip = 1;
-        return VIEW_W-1;  // included in line if drawn
+        return viewW-1;  // included in line if drawn
     }
     return (Uint)x1;
 }
@@ -890,22 +346,8 @@ static Uint scaleClipY(Uint y)
 
     clip = 0;
 
-    // the scaling needs to include a 0.5 factor so that the lines
-    // can be conceptually mid pixel.
-    // BUT y given is already 2y.
-
-    // floor((y+0.5)*2^scalebits)
-    
-    if (scalebits)
-    {
-        // (2y + 1)*2^(scalebits-1)
-        y1 = ((int)y + 1) << (scalebits-1);
-    }
-    else
-    {
-        // otherwise reduce to 1x
-        y1 = y>>1;
-    }
+    // see `setScale'
+    y1 = scaleY[y];
 
     // translate to view
     y1 -= viewy;
@@ -924,504 +366,561 @@ static Uint scaleClipY(Uint y)
 }
 
 
-static void finish()
+static BOOL followView()
 {
-    // this can cause generationFailed
+    // move the view if the player is outside the dead zone.
+    // return TRUE if moved.
     
-    Exit* e;
-    Uint n;
+    int x, y;
+    BOOL moved = FALSE;
 
-    Exit* entr = 0;
-    Exit* exit = 0;
-    Uint entrd = 0xff;
-    Uint exitd = 0xff;
+    if (!follow || zoom != MAX_ZOOM) return FALSE;
 
-    DPF(verbose, "finishing...\n");
+    // steps are whole cells, so the view remains cell aligned
+    x = player.pos.x - viewx;
+    while (x < FOLLOW_X1)
+    {
+        viewx -= FOLLOW_STEPX;
+        x += FOLLOW_STEPX;
+        moved = TRUE;
+    }
+    while (x >= FOLLOW_X2)
+    {
+        viewx += FOLLOW_STEPX;
+        x -= FOLLOW_STEPX;
+        moved = TRUE;
+    }
 
-    // first pass to finalise entrance and exit.
-    // go through remaining exits to see if any can be turned into
-    // actual exits
-    e = exits;
-    n = exitCount;
-    while (n)
+    y = player.pos.y - viewy;
+    while (y < FOLLOW_Y1)
     {
-        Ent ent;
+        viewy -= FOLLOW_STEPY;
+        y += FOLLOW_STEPY;
+        moved = TRUE;
+    }
+    while (y >= FOLLOW_Y2)
+    {
+        viewy += FOLLOW_STEPY;
+        y -= FOLLOW_STEPY;
+        moved = TRUE;
+    }
+    return moved;
+}
 
-        // normalise direction
-        if (e->d < 0) e->d = -e->d;
+BOOL toggleFollow()
+{
+    // turn camera follow on/off.
+    // return TRUE if the view has moved and needs a redraw.
+    follow = !follow;
+    return followView();
+}
 
-        ent.x = e->x;
-        ent.y = e->y;
-        ent.d = e->d;
+static int zoomView(int v, Uint z)
+{
+    // view coordinate `v' from the current level to the next level
+    // `z' up or down, as zoomFactors[z]/zoomFactors[zoom], which is
+    // 3/2 and 4/3 in turn. towards zero, as the division would be.
 
-        if (spontaneousExit2(&ent, e->room))
-        {
-            set_exit_door(e, ent.room);
-        }
-        else
-        {
-            uchar* tp = TILE_BASE(ent.x, ent.y);
-            if (ent.d == West && (!ent.x || tp[-1] == Unused))
-            {
-                Uint t = dist(e, 0, DUN_HEIGHT);
-                if (t < entrd)
-                {
-                    entrd = t;
-                    entr = e;
-                }
-            }
-            else if (ent.d == East && (ent.x == DUN_WIDTH || tp[1] == Unused))
-            {
-                Uint t = dist(e, DUN_WIDTH, 0);
-                if (t < exitd)
-                {
-                    exitd = t;
-                    exit = e;
-                }
-            }
-        }
+    BOOL neg = v < 0;
+    uint u = neg ? -v : v;
 
-        ++e;
-        --n;
-    }
+    if (z > zoom)
+        u = (zoom & 1) ? div16x8(u << 2, 3) : (u + (u << 1)) >> 1;
+    else
+        u = (z & 1) ? (u + (u << 1)) >> 2 : div16x8(u << 1, 3);
+
+    return neg ? -(int)u : (int)u;
+}
 
-    assert(entr);
-    assert(exit);
+static void setZoom(Uint z)
+{
+    // change zoom keeping the top left of the view on the same place
+    viewx = zoomView(viewx, z);
+    viewy = zoomView(viewy, z);
+    setScale(z);
+}
 
-    // mark entrance and exit doors
-    set_exit_door(entr, 0);
-    set_exit_door(exit, 0);
+void zoomIn()
+{
+    // increase scale
+    if (zoom < MAX_ZOOM)
+    {
+        setZoom(zoom + 1);
 
-    // assign room numbers
-    labelByDistance(entr->room);
+        // find the player
+        followView();
+    }
+}
 
-    entranceRoom = entr->room;
+void zoomOut()
+{
+    if (zoom) setZoom(zoom - 1);
+}
 
-    // place player at start position
-    player.room = entranceRoom;
-    player.pos.x = entr->x + 1;
-    player.pos.y = entr->y;
-    player.dir = East;
+void panXY(signed char x, signed char y)
+{
+    viewx += ((int)x)<<3;
+    viewy += ((int)y)<<3;
 
-    // coordinates are at max scale
-    scaleCoordMax(&player.pos);
+    //viewx += x;
+    //viewy += y;
 }
 
-static BOOL createFeature()
+
+static Int renderHLine(VHLine* hp)
 {
-    // return FALSE if cannot add another feature
-    // or if generationFailed
+    // return clip of y, > 0 when below the view
     
-    Uint cc = 0;
-    do
+    Uint u;
+    Uint v1, v2;
+    Int cl;
+    
+    u = scaleClipY(hp->u); // 2y
+    cl = clip;
+    if (!cl) // 0 <= y <= H-1
     {
-        Uint r;
-        Exit* e;
-        Ent ent;
-        BOOL rm;
-        BOOL v;
-
-        // choose a random side of a random room or corridor
-        do
-        {
-            r = randc(exitCount);
-            e = exits + r;
-        } while (EXIT_IS_FINAL(*e)); // find unused exit
+        v1 = scaleClipX(hp->v1);  // 2x
+        v2 = scaleClipX(hp->v2);
 
-        ent.x = e->x;
-        ent.y = e->y;
-        ent.d = e->d;
-
-        // build a corridor or a room?
-        if (ent.d < 0)
+        // when v1 is clipped to the left edge and the end is
+        // exactly on it, still draw the end.
+        if (v1 < v2 || !clip)
         {
-            // from corridor, must have a room
-            rm = TRUE;
-            ent.d = -ent.d;
-        }
-        else
-        {
-            rm = randc(128) < roomChance;
+            //plotHLine(x1, y, x2, 1);
+            plotSpan2(v1, u, v2-v1+2); //+2 ends included
         }
+    }
+    return cl;
+}
 
-        //v = spontaneousExit(&ent);
-        v = spontaneousExit2(&ent, e->room);
+static Int renderVLine(VHLine* vp)
+{
+    // return clip of x, > 0 when right of the view
+    
+    Uint u;
+    Uint v1, v2;
+    Int cl;
 
-        if (!v)
+    u = scaleClipX(vp->u); // pass in 2x
+    cl = clip;
+    if (!cl)
+    {
+        v1 = scaleClipY(vp->v1); // 2y
+        v2 = scaleClipY(vp->v2);
+        if (v1 < v2 || !clip)
         {
-            if (rm) v = randomRoom(&ent);
-            else v = randomCorridor(&ent);
-        }
+            //plotVLine(x, y1, y2, 1);
+            //plotVLine(x+1, y1, y2, 1); // x+1 ok, since we clip at w-1
 
-        if (v)
-        {
-            // mark exit as used
-            // exit goes from e->room to ent.room
-            set_exit_door(e, ent.room);
-            //memmove(e, e + 1, (--_nexits - r)*sizeof(Exit));
-            DPF1(verbose && cc > 9, "%d tries\n", cc + 1);
-            return TRUE;
+            // plot both lines together, includes ends
+            plotVLine2(u, v1, v2);
         }
-
-        if (generationFailed) break;
     }
-#ifdef SMALL
-    while (++cc != 0);  // exit after 256
-#else
-    while (++cc != 256);
-#endif    
- 
-    return FALSE;
+    return cl;
 }
 
-void zoomIn()
+static void renderVH()
 {
-    // increase scale
-    if (scalebits < MAX_SCALEBITS)
+    // render both horizontal lines and vertical lines interleaved
+    // so to reduce perceived delay slightly.
+    
+    VHLine* hp;
+    VHLine* vp;
+    
+    Uint nh;
+    Uint nv;
+
+    // hlines are 2x
+    hp = hlines;
+    nh = hlineCount;
+    vp = vlines;
+    nv = vlineCount;
+
+    do
     {
-        ++scalebits;
-        viewx <<= 1;
-        viewy <<= 1;
-    }
+        if (nh)
+        {
+            --nh;
+            if (renderHLine(hp) > 0) nh = 0; // done, y >= H
+            ++hp;
+        }
+
+        if (nv)
+        {
+            --nv;
+            if (renderVLine(vp) > 0) nv = 0;   // done, x >= w-1
+            ++vp;
+        }
+    } while (nh || nv);
 }
 
-void zoomOut()
+static void renderRoom(Uint i)
 {
-    if (scalebits)
-    {
-        --scalebits;
-        viewx >>= 1;
-        viewy >>= 1;
-    }
+    // render walls of room `i' (0-based)
+    
+    uint j;
+    
+    for (j = wallStart[i]; j < wallSplit[i]; ++j)
+        renderHLine(hlines + roomWalls[j]);
+            
+    for (; j < wallStart[i+1]; ++j)
+        renderVLine(vlines + roomWalls[j]);
 }
 
-void panXY(signed char x, signed char y)
+void renderRooms(const uchar* mask)
 {
-    viewx += ((int)x)<<3;
-    viewy += ((int)y)<<3;
+    // render only the walls of rooms in `mask'
+    // walls shared by two rooms are drawn twice, which is harmless.
+    
+    Uint i;
 
-    //viewx += x;
-    //viewy += y;
+    for (i = 0; i < roomCount; ++i)
+    {
+        if (ROOM_IN_MASK(mask, i+1)) renderRoom(i);
+    }
 }
 
-
-static void createHLines()
+static BOOL roomInView(Uint i)
 {
-    // the Hlines and Vlines are assumed to be in the middle of the pixel
-    // and therefore the endpoints are included.
+    // is any of the wall box of room `i' (0-based) in view?
+    // see `createRoomWalls'.
     
-    Uint x, y;
-    VHLine* hp = hlines;
-    uchar* tp = _tiles;
-
-    hlineCount = 0;
-
-    // arrange for all x coordinates to be 2x and y to be 2y
-    for (y = 0; y < DUN_HEIGHT*2; y+=2)
-    {
-        BOOL line = FALSE;
+    Room* rp = rooms + i;
+    
+    return scaleX[(rp->r.x1 - 1) << 1] < viewx + viewW
+        && scaleX[rp->r.x2 << 1] + 1 >= viewx
+        && scaleY[(rp->r.y1 - 1) << 1] < viewy + VIEW_H
+        && scaleY[rp->r.y2 << 1] >= viewy;
+}
 
-        for (x = 0; x < DUN_WIDTH*2; x+=2)
-        {
-            uchar c = *tp++;
-            if (c < ' ')
-            {
-                c &= East|West;
-                if (c == East)
-                {
-                    // start of line at (x,y)
-                    hp->u = y;
-                    hp->v1 = x;
-                    line = TRUE;
-                }
-                else if (c == West)
-                {
-                    // end of line
-                    hp->v2 = x;
-                    ++hp;
-                    ++hlineCount;
-                    line = FALSE;
-                }
-            }
-            else if (c == ClosedDoor)  // door
-            {
-                if (line)
-                {
-                    // break up line with door
-                    hp->v2 = x-1;
-                    ++hp;
+static BOOL renderOthers(const uchar* mask, uchar ignore)
+{
+    // render the rooms in view that are not in `mask', polling the
+    // keyboard after each as `renderOutward'.
+    // return FALSE if abandoned.
 
-                    hp->u = y;
-                    hp->v1 = x+1;
-                    ++hlineCount;
-                }
-            }
-        }
+    Uint i;
 
-        EPF1(line, "unclosed hline y=%d\n", y/2);
-    
+    for (i = 0; i < roomCount; ++i)
+    {
+        if (!ROOM_IN_MASK(mask, i+1) && roomInView(i))
+        {
+            renderRoom(i);
+            if (ignore != 0xff && (kbdWaiting() || (keyRows() & ~ignore)))
+                return FALSE;
+        }
     }
-
-    EPF1(hlineCount > MAX_HLINES, "too many hlines %d\n", hlineCount);
+    return TRUE;
 }
 
-static void createVLines()
+static BOOL renderOutward(uchar ignore)
 {
-    Uint x, y;
-    VHLine* vp = vlines;
+    // render room by room outward from the player, so the nearest
+    // walls are drawn first. after each room, poll the keyboard and
+    // give up if a key not in `ignore' is down or a key is queued.
+    // `ignore' 0xff never gives up.
+    // return FALSE if abandoned.
+
+    Uint queue[MAX_ROOMS];
+    uchar seen[ROOM_MASK_SIZE];
+    Uint top = 0;
+    Uint bot = 0;
+    Uint r;
+    Int i, j;
+
+    r = player.room;
+    if (!r)
+    {
+        renderVH();
+        return TRUE;
+    }
 
-    vlineCount = 0;
+    memset(seen, 0, ROOM_MASK_SIZE);
+    ROOM_SET_MASK(seen, r);
+    queue[bot++] = r;
 
-    // arrange for all x coordinates to be 2x and y to be 2y
-    for (x = 0; x < DUN_WIDTH*2; x += 2)
+    for (;;)
     {
-        BOOL line = FALSE;
-        for (y = 0; y < DUN_HEIGHT*2; y += 2)
+        while (top != bot)
         {
-            uchar c = GET_TILE2(x, y); // assumes x is 2x and y is 2y
-            if (c < ' ')
+            r = queue[top++];
+            renderRoom(r-1);
+
+            for (i = 0; i < MAX_ROOM_EXITS; ++i)
             {
-                c &= North|South;
-                if (c == South)
-                {
-                    // start of vline
-                    vp->u = x; // 2x
-                    vp->v1 = y; // 2y
-                    line = true;
-                }
-                else if (c == North)
+                j = getConnectedRoom(r, i);
+                if (j < 0) break;
+                if (j && !ROOM_IN_MASK(seen, j))
                 {
-                    vp->v2 = y;  // 2y
-                    ++vp;
-                    ++vlineCount;
-                    line = false;
+                    ROOM_SET_MASK(seen, j);
+                    queue[bot++] = j;
                 }
             }
-            else if (c == ClosedDoor)
-            {
-                if (line)
-                {
-                    // break vline with door
-                    vp->v2 = y-1;
-                    ++vp;
 
-                    vp->u = x;
-                    vp->v1 = y+1;
-                    ++vlineCount;
-                }
-            }
+            if (ignore != 0xff && (kbdWaiting() || (keyRows() & ~ignore)))
+                return FALSE;
         }
 
-        EPF(line, "unclosed vline\n");
+        // any rooms not connected
+        for (r = 1; r <= roomCount; ++r)
+        {
+            if (!ROOM_IN_MASK(seen, r))
+            {
+                ROOM_SET_MASK(seen, r);
+                queue[bot++] = r;
+                break;
+            }
+        }
+        if (top == bot) break;
     }
+    return TRUE;
+}
 
-    EPF1(vlineCount > MAX_VLINES, "too many vlines %d\n", vlineCount);
+static void localRooms(uchar* mask)
+{
+    // the player's room and those connected to it
+    
+    Int i, j;
+    Uint r = player.room;
+    
+    memset(mask, 0, ROOM_MASK_SIZE);
+    if (!r) return;
+
+    ROOM_SET_MASK(mask, r);
+    for (i = 0; i < MAX_ROOM_EXITS; ++i)
+    {
+        j = getConnectedRoom(r, i);
+        if (j < 0) break;
+        if (j) ROOM_SET_MASK(mask, j);
+    }
 }
 
-static void init()
+void initDungeon()
 {
-    memset(_tiles, Unused, DUN_WIDTH*DUN_HEIGHT);
-    generationFailed = FALSE;
-    exitCount = 0;
-    roomCount = 0;
-    corridorCount = 0;
+    // after `generateDungeon', when the arena no longer has
+    // the tile grid or the generator (see ovl.h).
+    
+    setScale(0);
+
+    if (!cols80) viewW = VIEW_W - PANEL_W*2;
+    
+    // the map cache only if as much again would be left,
+    // so not on 16K machines.
+    mapCache = arenaCache(MAPCACHE_SIZE, DUN_TILES);
+    mapCacheValid = FALSE;
 }
 
-BOOL generateDungeon()
+static void renderTile(uchar* buf, int vx, int vy)
 {
-    Ent e;
+    // render the 64x16 cells of the map at view (vx,vy) into `buf'
+    // by pointing the video at it.
+    
+    uchar* v = vidRam;
+    uchar w = viewW;
+#ifndef COLS80
+    uchar c80 = cols80;
+    cols80 = 0;
+#endif
 
-    // put data on stack
-    unsigned char tiles[DUN_WIDTH * DUN_HEIGHT];
+    vidRam = buf;
+    viewW = VIEW_W;
+    viewx = vx;
+    viewy = vy;
 
-    // set pointers to this data
-    _tiles = tiles;
+    memset(buf, ' ', TILE_STRIDE*MAPCACHE_H1/2);
+    renderVH();
 
-    init();
+#if TILE_STRIDE != 64
+    {
+        uchar r;
+        for (r = 1; r < MAPCACHE_H1/2; ++r)
+            memmove(buf + r*64, buf + r*TILE_STRIDE, 64);
+    }
+#endif
 
-    // place the first room in the centre
-    e.x = DUN_WIDTH/2;
-    e.y = DUN_HEIGHT/2;
-    e.d = Void;
-    randomRoom(&e);
+    vidRam = v;
+    viewW = w;
+#ifndef COLS80
+    cols80 = c80;
+#endif
+}
 
-    TPF("Generating Dungeon    ");
+static void buildMapCache()
+{
+    // pre-render zoom 1x and 2x
     
-    for (;;)
+    uchar* level0 = mapCache + MAPCACHE_W1*MAPCACHE_H1;
+    uchar* dp;
+    uchar* sp;
+    uchar i, r;
+    int vx = viewx;
+    int vy = viewy;
+    Uint z = zoom;
+
+    // 2x is 2x2 tiles, made using the 1x image as scratch
+    setScale(ZOOM_2X);
+    for (i = 0; i < 4; ++i)
     {
-        if (roomCount >= NUM_FEATUES) break; // enough
+        renderTile(level0, (i & 1) ? VIEW_W : 0, (i & 2) ? VIEW_H : 0);
 
-        TPF1("\b\b\b%2d%%", (int)(roomCount<<1));
-        if (!createFeature())
-            
+        dp = mapCache;
+        if (i & 1) dp += MAPCACHE_W1/2;
+        if (i & 2) dp += MAPCACHE_W1*(MAPCACHE_H1/2);
+
+        sp = level0;
+        for (r = 0; r < MAPCACHE_H1/2; ++r)
         {
-            DPF(verbose, "cannot add any more features\n");
-            break;
+            memcpy(dp, sp, MAPCACHE_W1/2);
+            dp += MAPCACHE_W1;
+            sp += MAPCACHE_W1/2;
         }
     }
 
-    TPF("\b\b\b100%%\n");
+    // 1x is the whole map
+    setScale(ZOOM_1X);
+    renderTile(level0, 0, 0);
 
-    if (!generationFailed)
-    {
-        finish();
-        createHLines();
-        createVLines();
-    }
-
-#ifdef STANDALONE
-    static void printDungeon();
-    if (verbose) printDungeon();
-#endif
-
-    return !generationFailed;
+    setScale(z);
+    viewx = vx;
+    viewy = vy;
+    mapCacheValid = TRUE;
 }
 
+static int cellRow(int y)
+{
+    // floor(y/3)
+    if (y < 0) return -(int)div16x8(2 - y, 3);
+    return div16x8(y, 3);
+}
 
+static void blitMapCache()
+{
+    // copy the view window out of the map cache into video
+    // assume screen is clear.
 
-#ifndef STANDALONE
+    uchar* sp = mapCache;
+    uchar* dp;
+    uchar w = MAPCACHE_W1;
+    uchar h = MAPCACHE_H1;
+    uchar r;
+    int cx, cy, x0, x1;
 
-static void renderVH()
-{
-    // render both horizontal lines and vertical lines interleaved
-    // so to reduce perceived delay slightly.
-    
-    VHLine* hp;
-    VHLine* vp;
-    
-    Uint nh;
-    Uint nv;
+    if (zoom == ZOOM_1X)
+    {
+        sp += MAPCACHE_W1*MAPCACHE_H1;
+        w = VIEW_W/2;
+        h = VIEW_H/3;
+    }
 
-    Uint u;
-    Uint v1, v2;
+    // the cache is in whole cells, so align the view to them
+    cy = cellRow(viewy);
+    viewy = cy*3;
+    viewx &= ~1;
+    cx = viewx >> 1;
 
-    // hlines are 2x
-    hp = hlines;
-    nh = hlineCount;
-    vp = vlines;
-    nv = vlineCount;
+    // visible columns
+    x0 = cx;
+    if (x0 < 0) x0 = 0;
+    x1 = cx + viewW/2;
+    if (x1 > w) x1 = w;
+    if (x0 >= x1) return;
 
-    do
+    for (r = 0; r < VIEW_H/3; ++r)
     {
-        if (nh)
-        {
-            --nh;
-            u = scaleClipY(hp->u); // 2y
-            if (clip > 0) nh = 0; // done, y >= H
-            else if (!clip) // 0 <= y <= H-1
-            {
-                v1 = scaleClipX(hp->v1);  // 2x
-                v2 = scaleClipX(hp->v2);
-                if (v1 < v2)
-                {
-                    //plotHLine(x1, y, x2, 1);
-                    plotSpan2(v1, u, v2-v1+2); //+2 ends included
-                }
-            }
-            ++hp;
-        }
-
-        if (nv)
+        if (cy >= 0 && cy < h)
         {
-            --nv;
-            u = scaleClipX(vp->u); // pass in 2x
-            if (clip > 0) nv = 0;   // done, x >= w-1
-            else if (!clip)
-            {
-                v1 = scaleClipY(vp->v1); // 2y
-                v2 = scaleClipY(vp->v2);
-                if (v1 < v2)
-                {
-                    //plotVLine(x, y1, y2, 1);
-                    //plotVLine(x+1, y1, y2, 1); // x+1 ok, since we clip at w-1
-
-                    // plot both lines together, includes ends
-                    plotVLine2(u, v1, v2);
-                }
-            }
-            ++vp;
+            dp = vidaddr(x0 - cx, r);
+            memcpy(dp, sp + cy*w + x0, x1 - x0);
+            VIDWRITES(x1 - x0);
         }
-    } while (nh || nv);
+        ++cy;
+    }
 }
 
-void renderDungeon()
+BOOL renderDungeonPoll(uchar ignore)
 {
+    // render the view, but can be abandoned if a key is pressed
+    // that is not in `ignore', see `keyRows'.
+    // return FALSE if abandoned, the screen is then incomplete.
+    
+    uchar mask[ROOM_MASK_SIZE];
+    BOOL done = TRUE;
+    
     //uchar vbuf[64*24]; // video double buffer
     //pushVideo(vbuf);
     cls();
 
-    // render the dungeon walls
-    renderVH();
+    // screen is clear, so no sprites are shown
+    spritesReset();
+    panelRedraw();
+
+    if (zoom == MAX_ZOOM && player.room)
+    {
+        // close up, the local rooms first as they matter most,
+        // then the others in view. in a corridor or doorway,
+        // everything below.
+        localRooms(mask);
+        renderRooms(mask);
+        done = renderOthers(mask, ignore);
+    }
+    else if (mapCache && (zoom == ZOOM_1X || zoom == ZOOM_2X))
+    {
+        if (!mapCacheValid) buildMapCache();
+        blitMapCache();
+    }
+    else
+    {
+        // render the dungeon walls, nearest first
+        done = renderOutward(ignore);
+    }
     
     //popVideo();
+    return done;
 }
 
-static const uchar playerSpriteE[] =
+void renderDungeon()
 {
-    0x04,0,1,
-    0x12,0,6,
-    0x04,0,
-    0,
-};
+    renderDungeonPoll(0xff);
+}
 
-static const uchar playerSpriteW[] =
-{
-    0x04,0,6,
-    0x02,0,1,
-    0x14,0,
-    0,
-};
+// compiled from sprdef.h
+#include "sprites.h"
 
-static const uchar playerSpriteN[] =
-{
-    0x02,0,4,
-    0x02,0x22,0,6,
-    0x02,0x22,0,
-    0,
-};
+#if SPRITE_CELLS > SPRITE_SAVE
+#error a sprite has more cells than the compositor saves
+#endif
 
-static const uchar playerSpriteS[] =
+static void _renderCreature(Creature* cr, uchar slot)
 {
-    0x02,0x22,0,6,
-    0x02,0x22,0,4,
-    0x02,0,
-    0,
-};
+    // show creature in compositor `slot', or hide it if not in view
+    
+    Coord c;
+    const CSprite* sp = 0;
 
-static void _renderCreature(Creature* cr, uchar col)
-{
-    if (scalebits == MAX_SCALEBITS)
+    // sprites reach a few pixels right of the hotspot,
+    // keep them off the panel.
+    c = cr->pos;
+    levelCoord(&c);
+    if (!clipCoord(&c) && c.x < viewW - SPRITE_REACH)
     {
-        Coord c;
-        c = cr->pos;
-        if (!clipCoord(&c))
+        switch (cr->dir)
         {
-            char x = c.x-1;
-            char y = c.y-1;
-            
-            const char* dp = 0;
-
-            switch (cr->dir)
-            {
-            case North:
-                dp = playerSpriteN;
-                break;
-            case East:
-                x -= 2;
-                dp = playerSpriteE;
-                break;
-            case South:
-                x -= 2;
-                dp = playerSpriteS;
-                break;
-            case West:
-                dp = playerSpriteW;
-                break;
-            }
-
-            if (dp) drawRLE(x, y, dp, col);
+        case North:
+            sp = &playerSpriteN;
+            break;
+        case East:
+            sp = &playerSpriteE;
+            break;
+        case South:
+            sp = &playerSpriteS;
+            break;
+        case West:
+            sp = &playerSpriteW;
+            break;
         }
     }
+
+    spriteSet(slot, c.x, c.y, sp);
 }
 
 static uchar _turnLeft(uchar d)
@@ -1440,34 +939,42 @@ static uchar _turnRight(uchar d)
 
 void renderPlayer()
 {
-    _renderCreature(CPLAYER, 1);
+    _renderCreature(CPLAYER, SLOT_PLAYER);
 }
 
 void turnLeft()
 {
     Creature* cr = CPLAYER;
-    _renderCreature(cr, 0);
     cr->dir = _turnLeft(cr->dir);
-    _renderCreature(cr, 1);
+    _renderCreature(cr, SLOT_PLAYER);
 }
 
 void turnRight()
 {
     Creature* cr = CPLAYER;
-    _renderCreature(cr, 0);
     cr->dir = _turnRight(cr->dir);
-    _renderCreature(cr, 1);
+    _renderCreature(cr, SLOT_PLAYER);
 }
 
-void moveFoward()
+static BOOL _moveCreature(Creature* cr, uchar slot)
 {
+    // step creature forward one position unless a wall is in the way.
+    // return TRUE if moved, the caller then shows it again, which
+    // only changes the cells at its edges.
+    
     Coord c;
-    c = player.pos;
+    Coord p;
+    Int dv;
+    Int hi;
+    char v;
+    BOOL under;
+
+    c = cr->pos;
 
     char dx = 0;
     char dy = 0;
 
-    switch (player.dir)
+    switch (cr->dir)
     {
         case North:
             --c.y;
@@ -1487,288 +994,208 @@ void moveFoward()
             break;
     }
 
-    // coordinate of "head"
-    Coord c2;
-    c2.x = c.x + dx;
-    c2.y = c.y + dy;
-    
-    if (!clipCoord(&c2))
+    // check the "head", the height or width of the sprite at MAX_ZOOM,
+    // in pixels of the current level. scaled down, they are under
+    // the sprite, so take it off meanwhile.
+    dv = -1;
+    hi = 1;
+    if (cr->dir & (North|South))
     {
-        Int dv;
-        char v;
-        if (player.dir & (East|West))
-        {
-            // check height of sprite
-            for (dv = -1; dv <= 1; ++dv)
-            {
-                v = getPixel(c2.x, c2.y + dv);
-                if (v == Floor) v = 0;
-                if (v) break;
-            }
-        }
-        else
-        {
-            // check width of sprite
-            for (dv = -3; dv <= 2; ++dv)
-            {
-                v = getPixel(c2.x + dv, c2.y);
-                if (v == Floor) v = 0;
-                if (v) break;
-            }
-        }
+        dv = -3;
+        hi = 2;
+    }
 
-        if (dv > 1)
-        {
-            _renderCreature(CPLAYER, 0);
-            player.pos = c;
-            _renderCreature(CPLAYER, 1);            
-        }
+    under = zoom != MAX_ZOOM;
+    if (under) spriteSet(slot, 0, 0, 0);
+
+    for (; dv <= hi; ++dv)
+    {
+        p.x = c.x + dx;
+        p.y = c.y + dy;
+        if (cr->dir & (East|West)) p.y += dv;
+        else p.x += dv;
+
+        levelCoord(&p);
+        if (clipCoord(&p)) break;
+        
+        v = getPixel(p.x, p.y);
+        if (v == Floor) v = 0;
+        if (v) break;
+    }
+
+    if (dv > hi)
+    {
+        cr->pos = c;
+        return TRUE;
     }
+
+    if (under) _renderCreature(cr, slot);
+    return FALSE;
 }
 
-#endif /* !STANDALONE */
+void moveFoward()
+{
+    Uint r;
+    BOOL redraw;
+    
+    if (_moveCreature(CPLAYER, SLOT_PLAYER))
+    {
+        // occasionally the view must move
+        redraw = followView();
+
+        // in a doorway, we are still in the last room
+        r = roomAt(&player.pos);
+        if (r) player.room = r;
+
+        // the view shows every room in it whichever we are in, so
+        // only a move of the view needs a redraw.
+
+        if (redraw) renderDungeon();
+        _renderCreature(CPLAYER, SLOT_PLAYER);
+    }
+}
 
 #ifdef STANDALONE
 
-static int unicode = 0;
+static int dumpText = 0;
+static const char* dumpPGM = 0;
+static int frameCount;
+
+static void frame(const char* what)
+{
+    // report frame, optionally dump it
+    
+    printf("frame %d %s: %lu writes\n", frameCount, what, vidWrites);
+    if (dumpText) hostDumpText(stdout);
+    if (dumpPGM)
+    {
+        char name[256];
+        FILE* fp;
+        sprintf(name, "%s%03d.pgm", dumpPGM, frameCount);
+        fp = fopen(name, "wb");
+        if (fp)
+        {
+            hostDumpPGM(fp);
+            fclose(fp);
+        }
+    }
+    ++frameCount;
+    vidWrites = 0;
+}
 
-static int convertToPrint(int c)
+static void renderFrames()
 {
-    int tile = c;
-    int u = c;
+    // zoom in on the entrance, then walk about.
+    // the walk is the same for the same seed.
     
-    if (!tile)
+    int i;
+    char buf[32];
+
+    viewx = viewy = 0;
+    setScale(0);
+    for (i = 0; i <= MAX_ZOOM; ++i)
     {
-        u = tile = '.';
+        if (i) zoomIn();
+        vidWrites = 0;
+        renderDungeon();
+        renderPlayer();
+        panelUpdate();
+        sprintf(buf, "zoom %d", i);
+        frame(buf);
     }
-    else if (tile < ' ')
+
+    for (i = 0; i < 100; ++i)
     {
-        switch (tile)
+        switch (randc(8))
         {
-        case North | South: // vwall
-            tile = 0xb3;  // single |
-            u = 0x2502;
-            break;
-        case East | West: // hwall
-            tile = 0xc4;
-            u = 0x2500;
-            break;
-        case East | South: // top left
-            tile = 0xda;
-            u = 0x250c;
-            break;
-        case North | East: // bottom left
-            tile = 0xC0;
-            u = 0x2514;
-            break;
-        case West | South: // top right
-            tile = 0xbf;
-            u = 0x2510;
-            break;
-        case North | West: // bottom right
-            tile = 0xd9;
-            u = 0x2518;
-            break;
-        case West | East | South: // hwall with south T
-            tile = 0xc2;
-            u = 0x252c;
-            break;
-        case West | East | North: // hwall with north T
-            tile = 0xc1;
-            u = 0x2534;
+        case 0:
+            turnLeft();
             break;
-        case North | South | West: // vwall left T
-            tile = 0xb4;
-            u = 0x2524;
-            break;
-        case North | South | East: // vwall right T
-            tile = 0xc3;
-            u = 0x251c;
-            break;
-        case North | South | East | West: // v & h intersection
-            tile = 0xc5;
-            u = 0x253c;
+        case 1:
+            turnRight();
             break;
         default:
-            u = tile = '?';
-            break;
+            moveFoward();
+            panelUpdate();
         }
+        sprintf(buf, "move %d", i);
+        frame(buf);
     }
-    return unicode ? u : tile;
 }
 
-
-    enum
-    {
-        UTFmax	= 4,		/* maximum bytes per rune */
-        Runesync	= 0x80,		/* cannot represent part of a UTF sequence (<) */
-        Runeself	= 0x80,		/* rune and UTF sequences are the same (<) */
-        Runeerror	= 0xFFFD,	/* decoding error in UTF */
-        Runemax	= 0x10FFFF,	/* maximum rune value */
-    };
-
-    enum 
-    {
-	Bit1	= 7,
-	Bitx	= 6,
-	Bit2	= 5,
-	Bit3	= 4,
-	Bit4	= 3,
-	Bit5	= 2,
-
-	T1	= ((1<<(Bit1+1))-1) ^ 0xFF,	/* 0000 0000 */
-	Tx	= ((1<<(Bitx+1))-1) ^ 0xFF,	/* 1000 0000 */
-	T2	= ((1<<(Bit2+1))-1) ^ 0xFF,	/* 1100 0000 */
-	T3	= ((1<<(Bit3+1))-1) ^ 0xFF,	/* 1110 0000 */
-	T4	= ((1<<(Bit4+1))-1) ^ 0xFF,	/* 1111 0000 */
-	T5	= ((1<<(Bit5+1))-1) ^ 0xFF,	/* 1111 1000 */
-
-	Rune1	= (1<<(Bit1+0*Bitx))-1,		/* 0000 0000 0111 1111 */
-	Rune2	= (1<<(Bit2+1*Bitx))-1,		/* 0000 0111 1111 1111 */
-	Rune3	= (1<<(Bit3+2*Bitx))-1,		/* 1111 1111 1111 1111 */
-	Rune4	= (1<<(Bit4+3*Bitx))-1,
-                                        /* 0001 1111 1111 1111 1111 1111 */
-
-	Maskx	= (1<<Bitx)-1,			/* 0011 1111 */
-	Testx	= Maskx ^ 0xFF,			/* 1100 0000 */
-
-	Bad	= Runeerror,
-    };
-
-static int UtoUtf8(char *str, unsigned long c)
+static unsigned long hashInt(unsigned long h, int v)
 {
-    // return number of bytes
-    /* Runes are signed, so convert to unsigned for range check. */
-        
-	/*
-	 * one character sequence
-	 *	00000-0007F => 00-7F
-	 */
-	if(c <= Rune1) {
-		str[0] = (char)c;
-		return 1;
-	}
-
-	/*
-	 * two character sequence
-	 *	0080-07FF => T2 Tx
-	 */
-	if(c <= Rune2) {
-		str[0] = (char)(T2 | (c >> 1*Bitx));
-		str[1] = (char)(Tx | (c & Maskx));
-		return 2;
-	}
-
-	/*
-	 * If the Rune is out of range, convert it to the error rune.
-	 * Do this test here because the error rune encodes to three bytes.
-	 * Doing it earlier would duplicate work, since an out of range
-	 * Rune wouldn't have fit in one or two bytes.
-	 */
-	if (c > Runemax)
-		c = Runeerror;
-
-	/*
-	 * three character sequence
-	 *	0800-FFFF => T3 Tx Tx
-	 */
-	if (c <= Rune3) {
-		str[0] = (char)(T3 |  (c >> 2*Bitx));
-		str[1] = (char)(Tx | ((c >> 1*Bitx) & Maskx));
-		str[2] = (char)(Tx |  (c & Maskx));
-		return 3;
-	}
-
-	/*
-	 * four character sequence (21-bit value)
-	 *     10000-1FFFFF => T4 Tx Tx Tx
-	 */
-	str[0] = T4 | (char)(c >> 3*Bitx);
-	str[1] = Tx | ((c >> 2*Bitx) & Maskx);
-	str[2] = Tx | ((c >> 1*Bitx) & Maskx);
-	str[3] = Tx | (c & Maskx);
-	return 4;
+    // FNV-1a of the low 16 bits
+    h = ((h ^ (v & 0xff))*16777619UL) & 0xffffffffUL;
+    return ((h ^ ((v >> 8) & 0xff))*16777619UL) & 0xffffffffUL;
 }
 
-static void printDungeon()
+static unsigned long hashDungeon()
 {
+    // the rooms and exits as the fields were before they were packed
+    // (see game.h), so sums match those of the layouts made then.
+    
+    unsigned long h = 2166136261UL;
+    Room* r;
+    Exit* e;
     int i;
+    int j;
+
+    h = hashInt(h, roomCount);
+    h = hashInt(h, corridorCount);
+    h = hashInt(h, exitCount);
     for (i = 0; i < roomCount; ++i)
     {
-        // draw the room numbers
-
-        Room* r = rooms + i;
-        Uint cx = ((r->r.x1 + r->r.x2)>>1)-1;
-        Uint cy = (r->r.y1 + r->r.y2)>>1;
-        char buf[3];
-        sprintf(buf, "%2d", r->no);
-        SET_TILE(cx, cy, buf[0]);
-        SET_TILE(cx+1, cy, buf[1]);
+        r = rooms + i;
+        h = hashInt(h, r->r.x1);
+        h = hashInt(h, r->r.y1);
+        h = hashInt(h, r->r.x2);
+        h = hashInt(h, r->r.y2);
+        h = hashInt(h, roomNo(r));
+        h = hashInt(h, roomIsCorridor(r));
+        for (j = 0; j < MAX_ROOM_EXITS; ++j) h = hashInt(h, r->exits[j]);
     }
-        
-    char buf[32];
-    for (int y = 0; y < DUN_HEIGHT; ++y)
+    for (i = 0; i < exitCount; ++i)
     {
-        for (int x = 0; x < DUN_WIDTH; ++x)
-        {
-            int t = convertToPrint(GET_TILE(x,y));
-            if (unicode)
-            {
-                int n = UtoUtf8(buf, t);
-                buf[n] = 0;
-                printf("%s", buf);
-            }
-            else
-            {
-                printf("%c", t);
-            }
-        }
-        printf("\n");
+        e = exits + i;
+        h = hashInt(h, e->x);
+        h = hashInt(h, e->y);
+        h = hashInt(h, (e->to & EXIT_CORRIDOR) ? -exitDir(e) : exitDir(e));
+        h = hashInt(h, (e->to & EXIT_FINAL) != 0);
+        h = hashInt(h, exitRoom(e));
+        h = hashInt(h, exitOther(e));
     }
+    h = hashInt(h, player.pos.x);
+    h = hashInt(h, player.pos.y);
+    return h;
+}
 
-    if (generationFailed) printf("GENERATION FAILED!\n");
-    printf("Number of rooms: %d\n", roomCount-corridorCount);
-    printf("Number of corridors: %d\n", corridorCount);
-    printf("Number of doors: %d\n", exitCount);
-    printf("Total features: %d\n", roomCount);
-    printf("total Hlines: %d\n", hlineCount);
-    printf("total Vlines: %d\n", vlineCount);
-
-    if (verbose > 1)
+static void checkSeeds(int n)
+{
+    // a line per seed, to compare with dungeon.chk
+    int s;
+    
+    verbose = 0;
+    for (s = 1; s <= n; ++s)
     {
-        // print rooms
-        int i;
-        for (i = 0; i < roomCount; ++i)
-        {
-            Room* r = rooms + i;
-            printf("(%d) -> ", r->no);
-
-            int j;
-            for (j = 0; j < MAX_ROOM_EXITS; ++j)
-            {
-                int k = getConnectedRoom(i + 1, j);
-                if (k < 0) break;
-                if (k)
-                {
-                    printf("%d ", rooms[k-1].no);
-                }
-                else
-                {
-                    printf("nowhere ");
-                }
-            }
-            printf("\n");
-        }
+        srand(s);
+        halt = 0;
+        arenaInit();
+        if (generateDungeon()) printf("%d %08lx\n", s, hashDungeon());
+        else printf("%d fail %d\n", s, (int)generationFailed);
     }
-    
 }
 
 int main(int argc, char** argv)
 {
-    seed(time(0));
-    
     int n = 1;
     int i;
+    int render = 0;
+    int check = 0;
+    uchar c80 = 0;
+
+    srand(time(0));
+
     for (i = 1; i < argc; ++i)
     {
         if (argv[i][0] == '-')
@@ -1781,6 +1208,36 @@ int main(int argc, char** argv)
             {
                 unicode = 1;
             }
+            if (!strcmp(argv[i], "-s") && i < argc-1)
+            {
+                srand(atoi(argv[++i]));
+            }
+            if (!strcmp(argv[i], "-r"))
+            {
+                // render frames and count video writes
+                render = 1;
+            }
+            if (!strcmp(argv[i], "-t"))
+            {
+                // frames as text
+                render = 1;
+                dumpText = 1;
+            }
+            if (!strcmp(argv[i], "-p") && i < argc-1)
+            {
+                // frames as <prefix>NNN.pgm
+                render = 1;
+                dumpPGM = argv[++i];
+            }
+            if (!strcmp(argv[i], "-80"))
+            {
+                c80 = 1;
+            }
+            if (!strcmp(argv[i], "-c") && i < argc-1)
+            {
+                // layouts of seeds 1 to n, see `make check'
+                check = atoi(argv[++i]);
+            }
         }
         else
         {
@@ -1788,8 +1245,19 @@ int main(int argc, char** argv)
         }
     }
 
+    hostInit(c80);
+    panelReset();
+
+    if (check)
+    {
+        checkSeeds(check);
+        return 0;
+    }
+
     for (i = 0; i < n && !halt && !generationFailed; ++i)
     {
+        // empty arena for each map, as each game on the target
+        arenaInit();
         generateDungeon();
 
         if (generationFailed)
@@ -1803,10 +1271,18 @@ int main(int argc, char** argv)
             case fail_max_exits:
                 printf("total exits exceeds %d\n", MAX_EXITS);
                 break;
+            case fail_no_memory:
+                printf("no room for %d tiles\n", DUN_TILES);
+                break;
             default:
                 printf("whatever\n");
             }
         }
+        else
+        {
+            initDungeon();
+            if (render) renderFrames();
+        }
     }
     
 	return 0;
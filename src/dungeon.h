@@ -29,12 +29,21 @@
  *  contact@voidware.com
  */
 
+// set of rooms, by 1-based room index
+#define ROOM_MASK_SIZE ((MAX_ROOMS+7)>>3)
+#define ROOM_IN_MASK(_m, _r)  ((_m)[((_r)-1)>>3] & (1<<(((_r)-1)&7)))
+#define ROOM_SET_MASK(_m, _r) ((_m)[((_r)-1)>>3] |= (1<<(((_r)-1)&7)))
+
+void initDungeon();
 BOOL generateDungeon();
 void renderDungeon();
+BOOL renderDungeonPoll(uchar ignore);
+void renderRooms(const uchar* mask);
 void renderPlayer();
 void zoomIn();
 void zoomOut();
 void panXY(signed char x, signed char y);
+BOOL toggleFollow();
 void turnLeft();
 void turnRight();
 void moveFoward();
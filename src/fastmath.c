@@ -0,0 +1,154 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include "defs.h"
+#include "fastmath.h"
+
+#ifdef STANDALONE
+
+uint mul8(uchar a, uchar b)
+{
+    return (uint)a*b;
+}
+
+uint mul16x8(uint a, uchar b)
+{
+    return (uint16)(a*b);
+}
+
+uint div16x8(uint a, uchar d)
+{
+    return a/d;
+}
+
+uchar div80(uint a)
+{
+    return a/80;
+}
+
+#else
+
+uint mul8(uchar a, uchar b) __naked
+{
+    // shift and add from the top bit of `b'
+    __asm
+        ld   hl,#2
+        add  hl,sp
+        ld   e,(hl)     // a
+        inc  hl
+        ld   a,(hl)     // b
+        ld   d,#0
+        jr   .mul
+    __endasm;
+}
+
+uint mul16x8(uint a, uchar b) __naked
+{
+    __asm
+        ld   hl,#2
+        add  hl,sp
+        ld   e,(hl)
+        inc  hl
+        ld   d,(hl)     // a
+        inc  hl
+        ld   a,(hl)     // b
+.mul:
+        ld   hl,#0
+        ld   b,#8
+.mu1:
+        add  hl,hl
+        rla
+        jr   nc,.mu2
+        add  hl,de
+.mu2:
+        djnz .mu1
+        ret
+    __endasm;
+}
+
+uint div16x8(uint a, uchar d) __naked
+{
+    // restoring division, a bit at a time into the remainder.
+    // the remainder is left in A.
+    __asm
+        ld   hl,#2
+        add  hl,sp
+        ld   e,(hl)
+        inc  hl
+        ld   d,(hl)     // a
+        inc  hl
+        ld   c,(hl)     // d
+        ex   de,hl
+        xor  a
+        ld   b,#16
+.dv1:
+        add  hl,hl
+        rla
+        jr   c,.dv2     // 9 bits, only if d > 127
+        cp   c
+        jr   c,.dv3
+.dv2:
+        sub  c
+        inc  l
+.dv3:
+        djnz .dv1
+        ret
+    __endasm;
+}
+
+uchar div80(uint a) __naked
+{
+    // the quotient fits 8 bits, so only 8 steps, subtracting
+    // 80<<7 down to 80.
+    __asm
+        pop  bc
+        pop  hl         // a
+        push hl
+        push bc
+        ld   de,#0x2800 // 80<<7
+        xor  a
+        ld   b,#8
+.d81:
+        sbc  hl,de      // carry is always clear here
+        jr   nc,.d82
+        add  hl,de      // restore, sets carry
+.d82:
+        ccf
+        rla             // quotient bit
+        srl  d
+        rr   e          // low bit of 80<<n is 0, carry clear
+        djnz .d81
+        ld   l,a
+        ret
+    __endasm;
+}
+
+#endif // STANDALONE
@@ -0,0 +1,391 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include "defs.h"
+#include "os.h"
+#include "file.h"
+
+#ifdef STANDALONE
+#include <stdlib.h>
+
+// the host file name, after the FCB fields used
+#define FCB_NAME    16
+#endif
+
+// FCB fields, the same for DOS 5 and 6
+#define FCB_BUF     3       // sector buffer
+#define FCB_EOF     8       // ending byte offset
+#define FCB_NRN     10      // next record number
+#define FCB_ERN     12      // ending record number
+
+#define FCB_WORD(_f, _o)    (*(uint16*)((_f)->fcb + (_o)))
+
+// DOS functions
+#define DOS_FSPEC   0
+#define DOS_INIT    1
+#define DOS_OPEN    2
+#define DOS_CLOSE   3
+#define DOS_READ    4
+#define DOS_WRITE   5
+
+uchar fileError;
+
+#ifdef STANDALONE
+
+int fileFailWrite;
+
+static uchar dosCall(uchar op, File* f, const void* hl)
+{
+    // simulated DOS on host files. the FCB is kept as the real one
+    // so the buffering above is the same.
+    
+    const char* s;
+    char* d;
+    long n;
+
+    switch (op)
+    {
+    case DOS_FSPEC:
+        // keep the name, SAVE/DAT:1 is save.dat
+        memset(f->fcb, 0, sizeof(f->fcb));
+        s = hl;
+        d = (char*)f->fcb + FCB_NAME;
+        while (*s > ' ' && *s != ':' && d < (char*)f->fcb + sizeof(f->fcb) - 1)
+        {
+            *d++ = *s == '/' ? '.' : *s;
+            ++s;
+        }
+        return 0;
+    case DOS_INIT:
+    case DOS_OPEN:
+        s = (char*)f->fcb + FCB_NAME;
+        f->fp = fopen(s, op == DOS_INIT ? "r+b" : "rb");
+        if (!f->fp && op == DOS_INIT) f->fp = fopen(s, "w+b");
+        if (!f->fp) return FILE_ERR_NOTFOUND;
+        fseek(f->fp, 0, SEEK_END);
+        n = ftell(f->fp);
+        FCB_WORD(f, FCB_NRN) = 0;
+        FCB_WORD(f, FCB_ERN) = n >> 8;
+        f->fcb[FCB_EOF] = n;
+        return 0;
+    case DOS_READ:
+        memset((uchar*)hl, 0, FILE_SECTOR);
+        fseek(f->fp, (long)FCB_WORD(f, FCB_NRN) << 8, SEEK_SET);
+        fread((uchar*)hl, 1, FILE_SECTOR, f->fp);
+        ++FCB_WORD(f, FCB_NRN);
+        return 0;
+    case DOS_WRITE:
+        if (fileFailWrite && !--fileFailWrite) return FILE_ERR_FULL;
+        fseek(f->fp, (long)FCB_WORD(f, FCB_NRN) << 8, SEEK_SET);
+        fwrite(hl, 1, FILE_SECTOR, f->fp);
+        if (++FCB_WORD(f, FCB_NRN) > FCB_WORD(f, FCB_ERN))
+        {
+            FCB_WORD(f, FCB_ERN) = FCB_WORD(f, FCB_NRN);
+            f->fcb[FCB_EOF] = 0;
+        }
+        return 0;
+    case DOS_CLOSE:
+        fclose(f->fp);
+        f->fp = 0;
+        if (f->mode == FILE_WRITE)
+        {
+            // cut the file at the EOF, as the directory entry would
+            n = ((long)FCB_WORD(f, FCB_ERN) << 8) + f->fcb[FCB_EOF];
+            s = (char*)f->fcb + FCB_NAME;
+            d = malloc(n + 1);
+            f->fp = fopen(s, "rb");
+            fread(d, 1, n, f->fp);
+            fclose(f->fp);
+            f->fp = fopen(s, "wb");
+            fwrite(d, 1, n, f->fp);
+            fclose(f->fp);
+            free(d);
+        }
+        return 0;
+    }
+    return 0;
+}
+
+#else
+
+static uchar dosSVC(uchar n, uchar* fcb, const void* hl) __naked
+{
+    // LS-DOS 6 supervisor call `n' with DE = fcb, HL = hl, B = 0 (LRL 256).
+    // return 0 or the DOS error code.
+    __asm
+        push ix
+        push iy
+        ld   ix,#6
+        add  ix,sp
+        ld   a,0(ix)    // n
+        ld   e,1(ix)
+        ld   d,2(ix)    // fcb
+        ld   l,3(ix)
+        ld   h,4(ix)    // hl
+        ld   b,#0
+        rst  0x28
+        ld   l,#0
+        jr   z,.sv1
+        ld   l,a        // error
+.sv1:
+        pop  iy
+        pop  ix
+        ret
+    __endasm;
+}
+
+static uchar dosVector(uint a, uchar* fcb, const void* hl) __naked
+{
+    // LDOS/TRSDOS, call `a' with DE = fcb, HL = hl, B = 0 (LRL 256).
+    // return 0 or the DOS error code.
+    __asm
+        push ix
+        push iy
+        ld   ix,#6
+        add  ix,sp
+        ld   bc,#.dv1   // return here
+        push bc
+        ld   c,0(ix)
+        ld   b,1(ix)    // a
+        push bc
+        ld   e,2(ix)
+        ld   d,3(ix)    // fcb
+        ld   l,4(ix)
+        ld   h,5(ix)    // hl
+        ld   b,#0
+        ret             // to `a'
+.dv1:
+        ld   l,#0
+        jr   z,.dv2
+        ld   l,a        // error
+.dv2:
+        pop  iy
+        pop  ix
+        ret
+    __endasm;
+}
+
+// by DOS_xxx
+static const uchar svcs[] = { 78, 58, 59, 60, 67, 75 };
+static const uint vectors[] = { 0x441c, 0x4420, 0x4424, 0x4428, 0x4436, 0x4439 };
+
+static uchar dosCall(uchar op, File* f, const void* hl)
+{
+    // the vectors are just memory without a DOS
+    if (!hasDOS) return FILE_ERR_NODOS;
+
+    // whole sectors go to or from the buffer in the FCB,
+    // which reading ahead moves along `buf'.
+    if (op == DOS_READ || op == DOS_WRITE) FCB_WORD(f, FCB_BUF) = (uint)hl;
+    
+    return useSVC ? dosSVC(svcs[op], f->fcb, hl)
+        : dosVector(vectors[op], f->fcb, hl);
+}
+
+#endif // STANDALONE
+
+BOOL fileOpen(File* f, const char* name, uchar mode)
+{
+    // `name' is a DOS filespec, eg. "SAVE/DAT:1"
+    
+    f->mode = mode;
+    f->err = 0;
+    f->i = 0;
+    f->n = 0;
+
+    fileError = dosCall(DOS_FSPEC, f, name);
+    if (!fileError)
+        fileError = dosCall(mode == FILE_WRITE ? DOS_INIT : DOS_OPEN, f, f->buf);
+
+    return !fileError;
+}
+
+static BOOL nextSector(File* f)
+{
+    // read the next sectors, up to FILE_AHEAD of them, return FALSE
+    // at EOF or error. the last sector may be part full, see FCB_EOF.
+    
+    uint r;
+    uint e;
+    uchar k;
+
+    f->i = 0;
+    f->n = 0;
+    fileError = 0;
+
+    for (k = 0; k < FILE_AHEAD; ++k)
+    {
+        r = FCB_WORD(f, FCB_NRN);
+        e = FCB_WORD(f, FCB_ERN);
+        if (r > e || (r == e && !f->fcb[FCB_EOF])) break;
+
+        // an error after the first is met again next time
+        fileError = dosCall(DOS_READ, f, f->buf + f->n);
+        if (fileError) break;
+
+        if (r == e)
+        {
+            f->n += f->fcb[FCB_EOF];
+            break;
+        }
+        f->n += FILE_SECTOR;
+    }
+
+    if (f->n)
+    {
+        fileError = 0;
+        return TRUE;
+    }
+    
+    if (!fileError) fileError = FILE_ERR_EOF;
+    return FALSE;
+}
+
+uint fileRead(File* f, void* p, uint n)
+{
+    // read up to `n' bytes, return the number read,
+    // less at EOF or error (see `fileError').
+
+    uchar* d = p;
+    uint m;
+
+    while (n)
+    {
+        if (f->i == f->n && !nextSector(f)) break;
+
+        m = f->n - f->i;
+        if (m > n) m = n;
+        memcpy(d, f->buf + f->i, m);
+        f->i += m;
+        d += m;
+        n -= m;
+    }
+    return d - (uchar*)p;
+}
+
+BOOL fileSeek(File* f, uint pos)
+{
+    // reading only, move to byte `pos' by setting the next record
+    // as @POSN would. return FALSE past the EOF.
+
+    uchar o = pos;
+    uint r = pos >> 8;
+
+    fileError = FILE_ERR_EOF;
+    if (f->mode != FILE_READ || r > FCB_WORD(f, FCB_ERN)) return FALSE;
+
+    FCB_WORD(f, FCB_NRN) = r;
+    f->i = 0;
+    f->n = 0;
+    fileError = 0;
+
+    if (o)
+    {
+        // into the sector, which must hold that much
+        if (!nextSector(f)) return FALSE;
+        if (f->n < o)
+        {
+            fileError = FILE_ERR_EOF;
+            return FALSE;
+        }
+        f->i = o;
+    }
+    return TRUE;
+}
+
+BOOL fileWrite(File* f, const void* p, uint n)
+{
+    // written a sector at a time as the buffer fills.
+    // after an error nothing more is written.
+    
+    const uchar* s = p;
+    uint m;
+
+    if (f->mode != FILE_WRITE)
+    {
+        fileError = FILE_ERR_ACCESS;
+        return FALSE;
+    }
+
+    fileError = f->err;
+    if (fileError) return FALSE;
+
+    while (n)
+    {
+        m = FILE_SECTOR - f->i;
+        if (m > n) m = n;
+        memcpy(f->buf + f->i, s, m);
+        f->i += m;
+        s += m;
+        n -= m;
+
+        if (f->i == FILE_SECTOR)
+        {
+            fileError = dosCall(DOS_WRITE, f, f->buf);
+            if (fileError)
+            {
+                f->err = fileError;
+                return FALSE;
+            }
+            f->i = 0;
+        }
+    }
+    return TRUE;
+}
+
+BOOL fileClose(File* f)
+{
+    uchar e;
+    
+    if (f->mode == FILE_WRITE && !f->err)
+    {
+        // the last sector is part full, write it and go back,
+        // so the EOF is where we finished.
+        e = f->i;
+        if (e)
+        {
+            f->err = dosCall(DOS_WRITE, f, f->buf);
+            if (!f->err) --FCB_WORD(f, FCB_NRN);
+        }
+
+        // a failed write leaves the NRN and EOF to the DOS
+        if (!f->err)
+        {
+            FCB_WORD(f, FCB_ERN) = FCB_WORD(f, FCB_NRN);
+            f->fcb[FCB_EOF] = e;
+        }
+    }
+
+    // close anyway
+    e = dosCall(DOS_CLOSE, f, f->buf);
+    fileError = f->err ? f->err : e;
+    return !fileError;
+}
@@ -0,0 +1,93 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#ifndef __file_h__
+#define __file_h__
+
+/* buffered DOS files.
+ *
+ * whole 256 byte sectors go through the DOS (LRL 0) into the sector
+ * buffer, and bytes are served from there, so a read of a few bytes
+ * costs a DOS call only once per sector. reading fills the buffer
+ * FILE_AHEAD sectors at a time, so a stream stops for the disk less
+ * often.
+ * Model 4 uses the LS-DOS 6 SVCs, Model I/III the LDOS/TRSDOS vectors.
+ * without a DOS every open fails with FILE_ERR_NODOS, and the Model I
+ * cassette build leaves this out altogether (see makefile).
+ * the host build has a simulated DOS on local files, see filetest.c.
+ */
+
+#ifdef STANDALONE
+#include <stdio.h>
+#endif
+
+#define FILE_SECTOR     256
+#define FILE_AHEAD      2   // sectors read at once
+
+// modes
+#define FILE_READ       0
+#define FILE_WRITE      1   // from the start, created if needed
+
+// some DOS error codes, see `fileError'
+#define FILE_ERR_NOTFOUND   0x18
+#define FILE_ERR_ACCESS     0x19    // eg. writing a file opened to read
+#define FILE_ERR_FULL       0x1b
+#define FILE_ERR_EOF        0x1c
+#define FILE_ERR_NODOS      0xff    // not DOS, there is none, see `hasDOS'
+
+typedef struct
+{
+    uchar       fcb[32];            // DOS file control block
+    uchar       buf[FILE_SECTOR*FILE_AHEAD];   // sector buffer
+    uint        i;                  // next byte in `buf'
+    uint        n;                  // bytes in `buf' when reading
+    uchar       mode;
+    uchar       err;                // first write error, see `fileClose'
+#ifdef STANDALONE
+    FILE*       fp;                 // simulated DOS
+#endif
+} File;
+
+// last DOS error, 0 if none
+extern uchar fileError;
+
+#ifdef STANDALONE
+// the simulated DOS fails this many writes on, 0 never
+extern int fileFailWrite;
+#endif
+
+BOOL fileOpen(File* f, const char* name, uchar mode);
+uint fileRead(File* f, void* p, uint n);
+BOOL fileSeek(File* f, uint pos);
+BOOL fileWrite(File* f, const void* p, uint n);
+BOOL fileClose(File* f);
+
+#endif // __file_h__
@@ -0,0 +1,226 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+/* host check of file.c through its simulated DOS.
+ *
+ * files of sizes either side of the sector boundaries are written
+ * in odd sized pieces, read back in others and seeked into, so
+ * the sector buffering is exercised as it is on the machine.
+ *
+ * build with `make check', which runs it. exits 1 on any failure.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "defs.h"
+#include "file.h"
+
+#define TEST_SPEC   "FTEST/DAT:1"
+#define TEST_HOST   "FTEST.DAT"
+#define TEST_MAX    3000
+
+static uchar data[TEST_MAX];
+static uchar got[TEST_MAX];
+static int failures;
+
+static void fail(const char* what, uint size, uint at)
+{
+    printf("filetest: %s, size %u at %u, error %02x\n",
+           what, size, at, (uint)fileError);
+    ++failures;
+}
+
+static long hostSize()
+{
+    long n = -1;
+    FILE* fp = fopen(TEST_HOST, "rb");
+    if (fp)
+    {
+        fseek(fp, 0, SEEK_END);
+        n = ftell(fp);
+        fclose(fp);
+    }
+    return n;
+}
+
+static void writeFile(uint size)
+{
+    // in pieces that do not line up with the sectors
+    static const uint pieces[] = { 1, 7, 100, 255, 256, 300 };
+    File f;
+    uint i = 0;
+    uint k = 0;
+    uint m;
+
+    if (!fileOpen(&f, TEST_SPEC, FILE_WRITE))
+    {
+        fail("open to write", size, 0);
+        return;
+    }
+
+    while (i < size)
+    {
+        m = pieces[k++ % 6];
+        if (m > size - i) m = size - i;
+        if (!fileWrite(&f, data + i, m)) fail("write", size, i);
+        i += m;
+    }
+
+    if (!fileClose(&f)) fail("close after write", size, i);
+    if (hostSize() != size) fail("size on disk", size, (uint)hostSize());
+}
+
+static void readFile(uint size)
+{
+    static const uint pieces[] = { 3, 256, 50, 511 };
+    File f;
+    uint i = 0;
+    uint k = 0;
+    uint m;
+
+    if (!fileOpen(&f, TEST_SPEC, FILE_READ))
+    {
+        fail("open to read", size, 0);
+        return;
+    }
+
+    for (;;)
+    {
+        m = fileRead(&f, got + i, pieces[k++ % 4]);
+        if (!m) break;
+        i += m;
+        if (i > size) break;
+    }
+
+    if (i != size) fail("read length", size, i);
+    else if (memcmp(got, data, size)) fail("read data", size, 0);
+    if (fileError != FILE_ERR_EOF) fail("no EOF", size, i);
+
+    fileClose(&f);
+}
+
+static void seekFile(uint size)
+{
+    static const uint at[] = { 0, 1, 255, 256, 257, 511, 512, 513, 1000 };
+    File f;
+    uint i;
+    uint p;
+    uint m;
+    uint want;
+
+    if (!fileOpen(&f, TEST_SPEC, FILE_READ))
+    {
+        fail("open to seek", size, 0);
+        return;
+    }
+
+    // forward and back across the sectors, then the very end
+    for (i = 0; i <= 9; ++i)
+    {
+        p = i < 9 ? at[8 - i] : size;
+        if (p > size) continue;
+
+        if (!fileSeek(&f, p))
+        {
+            fail("seek", size, p);
+            continue;
+        }
+
+        want = size - p;
+        if (want > 300) want = 300;
+        m = fileRead(&f, got, 300);
+        if (m != want) fail("read after seek", size, p);
+        else if (memcmp(got, data + p, m)) fail("data after seek", size, p);
+    }
+
+    if (fileSeek(&f, size + 1)) fail("seek past EOF", size, size + 1);
+    if (fileSeek(&f, (size | 0xff) + 1)) fail("seek past EOF", size, 0);
+
+    fileClose(&f);
+}
+
+int main()
+{
+    static const uint sizes[] =
+        { 0, 1, 255, 256, 257, 511, 512, 513, 1000, TEST_MAX, 300 };
+    File f;
+    uint i;
+
+    for (i = 0; i < TEST_MAX; ++i) data[i] = i*7 + (i >> 8);
+
+    // ends with a short file over the longest, which must be cut
+    for (i = 0; i < sizeof(sizes)/sizeof(sizes[0]); ++i)
+    {
+        writeFile(sizes[i]);
+        readFile(sizes[i]);
+        seekFile(sizes[i]);
+    }
+
+    // seeking is for reading
+    if (fileOpen(&f, TEST_SPEC, FILE_WRITE))
+    {
+        if (fileSeek(&f, 0)) fail("seek when writing", 0, 0);
+        fileClose(&f);
+    }
+
+    // and writing for writing
+    writeFile(300);
+    if (fileOpen(&f, TEST_SPEC, FILE_READ))
+    {
+        if (fileWrite(&f, data, 1) || fileError != FILE_ERR_ACCESS)
+            fail("write when reading", 300, 0);
+        fileClose(&f);
+    }
+    if (hostSize() != 300) fail("written when reading", 300, (uint)hostSize());
+
+    // the second sector fails, nothing more is written and the
+    // close leaves the EOF as the DOS has it, that of the old file.
+    if (fileOpen(&f, TEST_SPEC, FILE_WRITE))
+    {
+        fileFailWrite = 2;
+        if (!fileWrite(&f, data, 300)) fail("write", 1000, 0);
+        if (fileWrite(&f, data + 300, 700)) fail("write after full", 1000, 300);
+        if (fileWrite(&f, data + 1000, 1)) fail("write after error", 1000, 1000);
+        if (fileClose(&f) || fileError != FILE_ERR_FULL)
+            fail("close after error", 1000, 1000);
+        fileFailWrite = 0;
+    }
+    if (hostSize() != 300) fail("size after error", 1000, (uint)hostSize());
+
+    remove(TEST_HOST);
+
+    if (fileOpen(&f, TEST_SPEC, FILE_READ) || fileError != FILE_ERR_NOTFOUND)
+        fail("open missing file", 0, 0);
+
+    printf("filetest: %d failures\n", failures);
+    return failures != 0;
+}
@@ -14,7 +14,7 @@
 
 #ifdef STANDALONE
 
-static int verbose = 1;
+extern int verbose;
 
 // debug printf
 #define DPF(_c, _x)  if (_c) printf(_x)
@@ -63,13 +63,10 @@ typedef struct
 typedef struct
 {
     // prefix
-    uchar   id;
+    uchar   id;     // treasure table index + BASE_ID_TREASURE
     uchar   room;
     Coord   pos;
 
-    // treasure
-    const TreasureGen*    gen;
-    
 } Treasure;
 
 
@@ -109,20 +106,41 @@ typedef struct
     
 } Player;
 
+// room numbers and indexes fit 6 bits, leaving the top 2 for flags
+#define ROOM_BITS   0x3f
+
+#if MAX_ROOMS > ROOM_BITS
+#error room indexes must fit ROOM_BITS
+#endif
+
 enum RoomFlags
 {
     room_normal = 0,
-    room_corridor = 1,
+    room_corridor = 0x80,
 };
 
 typedef struct
 {
     Rect    r;
-    uchar   no; // room number
-    uchar   flags; // RoomFlags
+    uchar   nf; // room number, RoomFlags above
     uchar   exits[MAX_ROOM_EXITS];  // index into exits array, 1-based
 } Room;
 
+static inline uchar roomNo(const Room* r)
+{
+    return r->nf & ROOM_BITS;
+}
+
+static inline void roomSetNo(Room* r, uchar n)
+{
+    r->nf = (r->nf & ~ROOM_BITS) | (n & ROOM_BITS);
+}
+
+static inline BOOL roomIsCorridor(const Room* r)
+{
+    return (r->nf & room_corridor) != 0;
+}
+
 enum Direction
 {
     Void = 0,
@@ -133,16 +151,44 @@ enum Direction
 };
 
 
+// `to' flags
+#define EXIT_FINAL      0x40    // a door
+#define EXIT_CORRIDOR   0x80    // from a corridor, must lead to a room
+
 typedef struct 
 {
     uchar x;
     uchar y;
-    char d; // direction
-    uchar flags;
-    uchar room; // index into rooms when exit added
-    uchar otherroom;
+    uchar from; // index into rooms when exit added, direction on top
+    uchar to;   // other room or 0, flags above
 } Exit;
 
+static inline uchar exitRoom(const Exit* e)
+{
+    return e->from & ROOM_BITS;
+}
+
+static inline uchar exitOther(const Exit* e)
+{
+    return e->to & ROOM_BITS;
+}
+
+static inline uchar exitDir(const Exit* e)
+{
+    // kept as 0-3 for North, East, South, West
+    return 1 << (e->from >> 6);
+}
+
+static inline void exitSetFrom(Exit* e, uchar room, uchar d)
+{
+    e->from = (room & ROOM_BITS) | (((d >> 1) - (d >> 3)) << 6);
+}
+
+static inline void exitSetOther(Exit* e, uchar room)
+{
+    e->to = (e->to & ~ROOM_BITS) | (room & ROOM_BITS);
+}
+
 
 extern Player player;
 extern uchar roomCount, corridorCount;
@@ -154,5 +200,11 @@ extern Exit exits[];
 
 #define CPLAYER ((Creature*)&player)
 
+// monster speed, game ticks (see rtc.h) between monster moves.
+// as the original's slow, medium and fast; the time you have to react.
+#define MONSTER_SLOW    45
+#define MONSTER_MEDIUM  30
+#define MONSTER_FAST    15
+
 #define BASE_ID_TREASURE 101
 
@@ -0,0 +1,192 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+/* host backend, STANDALONE only.
+ *
+ * Provides what the renderer needs from os.c, with video in memory.
+ * rand.c is shared with the target, so a seed gives the same dungeon.
+ */
+
+#include <stdlib.h>
+#include <stdarg.h>
+#include "defs.h"
+#include "os.h"
+#include "plot.h"
+#include "host.h"
+
+uchar TRSModel = 3;
+uchar TRSMemory = 48;
+#ifndef COLS80
+uchar cols80;
+#endif
+uchar* vidRam;
+unsigned int cursorPos;
+
+// video writes by plot, see VIDWRITES
+unsigned long vidWrites;
+
+static uchar video[VIDSIZE80];
+
+void hostInit(uchar c80)
+{
+    // as Model III or Model 4 in 80 columns
+#ifndef COLS80
+    cols80 = c80;
+#endif
+    if (cols80) TRSModel = 4;
+    vidRam = video;
+    cls();
+}
+
+uchar* vidaddrfor(uint a)
+{
+    if (a >= VIDSIZE80 || (a >= VIDSIZE && !cols80)) return 0;
+    return vidRam + a;
+}
+
+uchar* vidaddr(char x, char y)
+{
+    uint a = ((uint)y) << 6;
+    if (cols80) a += ((uint)y) << 4;
+    return vidaddrfor(a + x);
+}
+
+void clsc(uchar c)
+{
+    uint n = VIDSIZE;
+    if (cols80) n = VIDSIZE80;
+    memset(vidRam, c, n);
+    VIDWRITES(n);
+    cursorPos = 0;
+}
+
+void cls()
+{
+    clsc(' ');
+}
+
+int sprintf_simple(char* buf, const char* f, ...)
+{
+    int n;
+    va_list args;
+    va_start(args, f);
+    n = vsprintf(buf, f, args);
+    va_end(args);
+    return n;
+}
+
+uchar keyRows()
+{
+    // no keyboard
+    return 0;
+}
+
+BOOL kbdWaiting()
+{
+    return FALSE;
+}
+
+static void screenSize(uchar* w, uchar* h)
+{
+    *w = 64;
+    *h = 16;
+    if (cols80)
+    {
+        *w = 80;
+        *h = 24;
+    }
+}
+
+void hostDumpText(FILE* fp)
+{
+    // each cell is 2x3 characters, '#' for a pixel.
+    // text cells show the character top left.
+    
+    uchar w, h, x, y, r;
+    uchar* m;
+
+    screenSize(&w, &h);
+    for (y = 0; y < h; ++y)
+    {
+        for (r = 0; r < 3; ++r)
+        {
+            m = vidaddr(0, y);
+            for (x = 0; x < w; ++x)
+            {
+                uchar c = *m++;
+                if (c & 0x80)
+                {
+                    putc((c & (1 << (r*2))) ? '#' : '.', fp);
+                    putc((c & (2 << (r*2))) ? '#' : '.', fp);
+                }
+                else
+                {
+                    putc(r || c < ' ' ? ' ' : c, fp);
+                    putc(' ', fp);
+                }
+            }
+            putc('\n', fp);
+        }
+    }
+}
+
+void hostDumpPGM(FILE* fp)
+{
+    // one byte per pixel, pixels white on black.
+    // text cells are a grey block.
+    
+    uchar w, h, x, y, r;
+    uchar* m;
+
+    screenSize(&w, &h);
+    fprintf(fp, "P5\n%d %d\n255\n", w*2, h*3);
+    for (y = 0; y < h; ++y)
+    {
+        for (r = 0; r < 3; ++r)
+        {
+            m = vidaddr(0, y);
+            for (x = 0; x < w; ++x)
+            {
+                uchar c = *m++;
+                uchar a = 0;
+                uchar b = 0;
+                if (c & 0x80)
+                {
+                    if (c & (1 << (r*2))) a = 255;
+                    if (c & (2 << (r*2))) b = 255;
+                }
+                else if (c > ' ') a = b = 128;
+                putc(a, fp);
+                putc(b, fp);
+            }
+        }
+    }
+}
@@ -0,0 +1,183 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include <string.h>
+#include "defs.h"
+#include "os.h"
+#include "rtc.h"
+#include "kbd.h"
+
+// must be a power of 2
+#define KBD_QSIZE       16
+
+// in RTC ticks at 30Hz, doubled on the Model 4 at 60Hz
+#define KBD_DEBOUNCE    2
+#define KBD_DELAY       8
+#define KBD_RATE        2
+
+static const char keyMatrix[] =
+{
+    '@', 'A', 'B', 'C', 'D', 'E', 'F', 'G',
+    'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O',
+    'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W',
+    'X', 'Y', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z',
+    '0', '1', '2', '3', '4', '5', '6', '7',
+    '8', '9', ':', ';', ',', '-', '.', '/',
+    '\r', '\b', 'Z', KEY_ARROW_UP, KEY_ARROW_DOWN, KEY_ARROW_LEFT, KEY_ARROW_RIGHT, ' ',
+};
+
+// written by `kbdScan', maybe in the interrupt, read by `kbdGet'
+static char kbdQ[KBD_QSIZE];
+static volatile uchar kbdHead;
+static volatile uchar kbdTail;
+
+static uchar kbdKey;            // matrix index + 1 of the key down or 0
+static uchar kbdCount;          // scans `kbdKey' has been down
+static uchar kbdDebounce;
+static uchar kbdDelay;
+static uchar kbdRate;
+
+// bit per matrix index of keys that do not repeat
+static uchar kbdOnce[sizeof(keyMatrix)/8];
+
+void kbdRepeat(uchar delay, uchar rate)
+{
+    // in scans, rate <= delay
+    kbdDelay = delay;
+    kbdRate = rate;
+}
+
+void kbdNoRepeat(const char* keys)
+{
+    uchar i;
+    
+    memset(kbdOnce, 0, sizeof(kbdOnce));
+    for (i = 0; i < sizeof(keyMatrix); ++i)
+        if (strchr(keys, keyMatrix[i])) kbdOnce[i >> 3] |= 1 << (i & 7);
+}
+
+void kbdInit()
+{
+    kbdHead = kbdTail = 0;
+    kbdKey = 0;
+    
+    if (rtcOn)
+    {
+        uchar s = TRSModel >= 4 ? 1 : 0;
+        kbdDebounce = KBD_DEBOUNCE << s;
+        kbdRepeat(KBD_DELAY << s, KBD_RATE << s);
+    }
+    else
+    {
+        // polled, the loop is slow enough to debounce and
+        // repeats every poll.
+        kbdDebounce = 1;
+        kbdRepeat(1, 1);
+    }
+}
+
+static void kbdPut(uchar k)
+{
+    uchar t = (kbdTail + 1) & (KBD_QSIZE-1);
+    if (t != kbdHead)
+    {
+        kbdQ[kbdTail] = keyMatrix[k];
+        kbdTail = t;
+    }
+}
+
+void kbdScan()
+{
+    // find the first key down in rows 0-6 (not shift)
+    
+    uchar r = 1;
+    uchar k = 0;
+    uchar v;
+
+    do
+    {
+        v = cols80 ? *(KBBASE80 + r) : *(KBBASE + r);
+        if (v)
+        {
+            while (!(v & 1))
+            {
+                v >>= 1;
+                ++k;
+            }
+            ++k;
+            break;
+        }
+        k += 8;
+        r <<= 1;
+    } while (r != 0x80);
+
+    if (r == 0x80) k = 0;
+
+    if (k != kbdKey)
+    {
+        // new key or released
+        kbdKey = k;
+        kbdCount = 0;
+        return;
+    }
+
+    if (!k) return;
+
+    --k;
+    if (++kbdCount == kbdDebounce) kbdPut(k);
+    else if (kbdCount == kbdDebounce + kbdDelay)
+    {
+        kbdCount -= kbdRate;
+        if (!(kbdOnce[k >> 3] & (1 << (k & 7))) && kbdHead == kbdTail)
+            kbdPut(k);
+    }
+}
+
+char kbdGet()
+{
+    // return the next key or 0 if none
+    char c = 0;
+    
+    if (!rtcOn) kbdScan();
+
+    if (kbdHead != kbdTail)
+    {
+        c = kbdQ[kbdHead];
+        kbdHead = (kbdHead + 1) & (KBD_QSIZE-1);
+    }
+    return c;
+}
+
+BOOL kbdWaiting()
+{
+    // is there a key in the queue
+    return kbdHead != kbdTail;
+}
@@ -0,0 +1,90 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+/* launcher for the model specific builds.
+ *
+ * runs APSHAI4 on a Model 4 under LS-DOS 6 (80 columns) and APSHAI3
+ * on everything else (64 columns). only needs crt0, not the runtime.
+ */
+
+#include "defs.h"
+
+static const char cmd3[] = "APSHAI3\r";
+static const char cmd4[] = "APSHAI4\r";
+
+static uchar isModel4() __naked
+{
+    // as `getModel', a Model 4 under DOS 6 has RAM at 0x2000
+    // interrupts are still off from crt0.
+    __asm
+        ld   hl,#0x2000
+        ld   a,(hl)     // get original
+        ld   b,a        // save
+        xor  #0xff      // flip bits
+        ld   (hl),a
+        xor  (hl)       // mask
+        ld   (hl),b     // restore original
+        ld   l,#1
+        ret  z          // RAM, model 4
+        dec  l
+        ret
+    __endasm;
+}
+
+static void runDOS6(const char* cmd) __naked
+{
+    // does not return
+    __asm
+        pop  bc         // ret
+        pop  hl         // cmd
+        ei
+        ld   a,#24      // @CMNDI
+        rst  0x28
+    __endasm;
+}
+
+static void runDOS5(const char* cmd) __naked
+{
+    // does not return
+    __asm
+        pop  bc         // ret
+        pop  hl         // cmd
+        ei
+        jp   0x4405     // CMNDI
+    __endasm;
+}
+
+int main()
+{
+    if (isModel4()) runDOS6(cmd4);
+    else runDOS5(cmd3);
+    return 0;
+}
@@ -0,0 +1,2 @@
+/* generated by tools/melody from melodies.txt. do not edit */
+
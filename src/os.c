@@ -36,12 +36,17 @@
 
 #include "defs.h"
 #include "os.h"
+#include "task.h"
+#include "rand.h"
+#include "fastmath.h"
 
 // store our own cursor position (do not use the OS location)
 unsigned int cursorPos;
 
 // are we in 80 col mode?
+#ifndef COLS80
 uchar cols80;
+#endif
 
 // location of video ram 0x3c00 or 0xf800
 uchar* vidRam;
@@ -50,6 +55,9 @@ uchar* vidRam;
 uchar TRSModel;
 uchar useSVC;
 
+// is there a DOS to call? (initModel)
+uchar hasDOS;
+
 // should output be converted to upper case?
 uchar TRSUppercaseOutput;
 
@@ -57,9 +65,9 @@ uchar TRSUppercaseOutput;
 uchar TRSMemory;
 uchar* TRSMemoryFail;
 
+// effective clock in kHz (initModel)
+uint cpuKHz;
 
-// random number seed
-static uint seed;
 
 static uchar* OldStack;
 static uchar* NewStack;
@@ -88,22 +96,53 @@ uchar* vidaddr(char x, char y)
     return vidaddrfor(vidoff(x,y));
 }
 
-static void setChar(volatile char* a, char c)
+// video character for each character, see `initCaseTable'
+static uchar caseTable[256];
+
+static void initCaseTable()
 {
+    // find out once if a Model I has the lower case mod, and make
+    // the table to convert output to upper case if not.
+
+    volatile char* a = vidRam;
+    char c = *a;
+    uchar i = 0;
+
     if (TRSModel <= 2)
     {
-        // Each time we see a T, check for lcase mod?
-        if (c == 'T')
-        {
-            // 20 displays the same as T, 20+64=84=T
-            *a = 20;
-            TRSUppercaseOutput = (*a != 20);
-        }
-
-        if (TRSUppercaseOutput) c = toupper(c);
+        // 20 displays the same as T, 20+64=84=T
+        *a = 20;
+        TRSUppercaseOutput = (*a != 20);
+        *a = c;
     }
 
-    *a = c;
+    do
+    {
+        caseTable[i] = TRSUppercaseOutput ? toupper(i) : i;
+    } while (++i);
+}
+
+static void setChar(volatile char* a, char c)
+{
+    *a = caseTable[(uchar)c];
+}
+
+void blitText(char x, char y, const char* s, uchar n)
+{
+    // copy up to `n' characters of `s' to (x,y) directly.
+    // no cursor, no control characters, clipped to the line.
+
+    uchar* p = vidaddr(x, y);
+    uchar w = (cols80 ? 80 : 64) - x;
+
+    if (!p) return;
+    if (n > w) n = w;
+    
+    while (n && *s)
+    {
+        *p++ = caseTable[(uchar)*s++];
+        --n;
+    }
 }
 
 void outcharat(char x, char y, char c)
@@ -119,8 +158,7 @@ static uint nextLinePos()
     if (cols80)
     {
         // bump a to the next multiple of 80
-        uchar q = a/80;
-        a = (q + 1)*80;
+        a = MUL80(div80(a) + 1);
     }
     else
     {
@@ -403,91 +441,71 @@ static void setSpeed(uchar fast)
     }
 }
 
-
-static const char keyMatrix[] =
+static uint rtcCount() __naked
 {
-    '@', 'A', 'B', 'C', 'D', 'E', 'F', 'G',
-    'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O',
-    'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W',
-    'X', 'Y', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z',
-    '0', '1', '2', '3', '4', '5', '6', '7',
-    '8', '9', ':', ';', ',', '-', '.', '/',
-    '\r', '\b', 'Z', KEY_ARROW_UP, KEY_ARROW_DOWN, KEY_ARROW_LEFT, KEY_ARROW_RIGHT, ' ',
-    'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 'Z', 
-};
-
-static uchar keyRow = 7;
-static uchar keyCol;
-static uchar keyHold;
-
-static uchar readKeyRowCol()
+    // count 34 T-state loops over one RTC period, polled with
+    // interrupts off. bit 2 of port 0xE0 goes low on the tick and
+    // reading port 0xEC clears it. return 0 if no tick comes.
+    __asm
+        di
+        ld   de,#0
+.rc1:
+        in   a,(#0xe0)
+        bit  2,a
+        jr   z,.rc2
+        dec  de
+        ld   a,d
+        or   e
+        jr   nz,.rc1
+        ld   hl,#0
+        ret
+.rc2:
+        in   a,(#0xec)  // clear, maybe stale, wait a whole period
+.rc3:
+        in   a,(#0xe0)
+        bit  2,a
+        jr   nz,.rc3
+        in   a,(#0xec)
+        ld   hl,#0
+.rc4:
+        inc  hl         // 6
+        in   a,(#0xe0)  // 11
+        and  #4         // 7
+        jp   nz,.rc4    // 10
+        in   a,(#0xec)
+        ret
+    __endasm;
+}
+
+static void measureSpeed()
 {
-    uchar r = 1;
-    uchar i;
-    uchar hit = 0;
+    // speed-up kits and emulators make the nominal clock a guess.
+    // the Model I has no tick to time against, so take its word.
+    // kHz = n*34*30/1000, about n + n/50 at the III's 30Hz and
+    // twice that for the 4 at 60Hz.
+    uint n;
 
-    static uchar kbrows[8];
+    cpuKHz = 1774;
+    if (TRSModel < 3) return;
 
-    for (i = 0; i < 8; ++i)
+    n = rtcCount();
+    if (n)
     {
-        uchar v = cols80 ? *(KBBASE80 + r) : *(KBBASE + r);
-        r <<= 1;
-
-        uchar t = v ^ kbrows[i];
-
-        if (t)
-        {
-            kbrows[i] = v;
-            keyHold = 0;
-
-            // press not release            
-            if (!hit && (v & t))
-            {
-                hit = 1;
-
-                keyRow = i;
-                keyCol = 0;
-                keyHold = 1;
-                
-                while (t > 1)
-                {
-                    t >>= 1;
-                    ++keyCol;
-                }
-            }
-        }
+        cpuKHz = n + div16x8(n, 50);
+        if (TRSModel >= 4) cpuKHz <<= 1;
     }
-
-    return hit;
+    else cpuKHz = TRSModel >= 4 ? 4055 : 2028;
 }
 
 
-char scanKeyMatrix(char hold)
+uchar keyRows()
 {
-    // return key if pressed or 0
-
-    // ignore shift & control
-    char c = 0;
-    uchar hit;
-    
-    hit = readKeyRowCol();
-
-    if (keyHold)
-    {
-        if (keyRow != 7)
-        {
-            c = keyMatrix[keyRow*8 + keyCol];
-            if (!hit && hold != c)
-            {
-                keyHold = 0;
-                c = 0;
-            }
-        }
-    }
-    
-    return c;
+    // cheap poll of the keyboard. return the columns down in any of
+    // the rows 0-6 (not shift), by reading all rows at once.
+    return cols80 ? *(KBBASE80 + 0x7f) : *(KBBASE + 0x7f);
 }
 
+
 // call the ROM to scan a key
 char scanKey()
 {
@@ -540,7 +558,10 @@ void setIdleHandler(IdleHandler h, uchar d)
 static void _keyIdle()
 {
     // stir random number
-    ++seed;
+    randStir();
+
+    // spend the wait on background work
+    taskRun();
     
     if (idleHandler)
     {
@@ -621,8 +642,8 @@ static void setROMCursor()
 {
     if (useSVC)
     {
-        c4row = cursorPos/80;
-        c4col = cursorPos - c4row*80;
+        c4row = div80(cursorPos);
+        c4col = cursorPos - MUL80(c4row);
         
         __asm
             ld  a,#15   // @VDCTL
@@ -680,8 +701,8 @@ char getSingleChar(const char* msg)
 
 void pause()
 {
-    // delay, unless key pressed
-    int c = 1000;  // XX scale delay by machine speed
+    // delay, unless key pressed. 1000 scans on the Model I
+    uint c = mul16x8(cpuKHz >> 4, 9);
     while (--c)
     {
         if (scanKey()) return;
@@ -690,7 +711,27 @@ void pause()
 
 void outs(const char* s)
 {
-    while (*s) outchar(*s++);
+    // copy runs of plain characters straight to video,
+    // leave the rest to `outchar'
+    
+    uint a;
+    uint n = cols80 ? VIDSIZE80 : VIDSIZE;
+    uchar* p;
+    
+    while (*s)
+    {
+        a = cursorPos;
+        p = vidRam + a;
+        while (*s >= ' ' && a < n)
+        {
+            *p++ = caseTable[(uchar)*s++];
+            ++a;
+        }
+        cursorPos = a;
+
+        if (a >= n) nextLine(); // scroll and place on last line
+        else if (*s) outchar(*s++);
+    }
 }
 
 void outint(int v)
@@ -884,17 +925,30 @@ void initModel()
 {
     uchar* rp = (uchar*)0x4000;
     
+#ifndef COLS80
     cols80 = 0;
+#endif
     vidRam = VIDRAM;
     TRSMemory = 0;
 
     TRSModel = getModel();
 
+#if defined(MODEL) && MODEL == 1
+    // the cassette build, nothing of a DOS and code may be there
+    hasDOS = 0;
+#else
+    // LDOS/TRSDOS 5 has jumps at its vectors, see file.c.
+    // otherwise a Level II ROM or a cassette load.
+    hasDOS = TRSModel >= 4 || (rp[0x41c] == 0xc3 && rp[0x436] == 0xc3);
+#endif
+
     if (TRSModel >= 4)
     {
         char* h = getHigh();
         
+#ifndef COLS80
         cols80 = 1;
+#endif
         useSVC = 1;
         vidRam = VIDRAM80;
 
@@ -921,17 +975,21 @@ void initModel()
         }
         NewStack = rp;
 
-        if (TRSModel <= 2)
-        {
-            // convert output to upper case
-            TRSUppercaseOutput = 1;
-        }
     }
 
+    measureSpeed();
+    initCaseTable();
+
     // switch interrupts back on now we're done poking around memory
     enableInterrupts();
 }
 
+uchar* ramTop()
+{
+    // top of free RAM, where `setStack' will put the stack
+    return NewStack;
+}
+
 void setStack() __naked
 {
     // locate the stack to `NewStack`
@@ -955,66 +1013,6 @@ void revertStack() __naked
     __endasm;
 }
 
-void srand(uint v)
-{
-    seed = v;
-}
-
-unsigned int rand16()
-{
-    uint v;
-    uchar a;
-
-    v = (seed + 1)*75;
-    a = v;
-    a -= (v >> 8);
-    seed = ((v & 0xff00) | a) - 1;
-    return seed;
-}
-
-uint randn(uint n)
-{
-    // random [0,n-1]
-    // 16 bit version
-    
-    uint c = 1;
-    uint v;
-
-    while (c < n) c <<= 1;
-    --c;
-    
-    do
-    {
-        v = rand16() & c;
-    } while (v >= n);
-    
-    return v;
-}
-
-uchar randc(uchar n)
-{
-    // random [0,n-1]
-    // 8 bit version
-
-    uchar v;
-    uchar c = 0xff;
-    
-    if (n <= 128)
-    {
-        c = 1;
-        while (c < n) c <<= 1;
-        --c;
-    }
-
-    do
-    {
-        v = rand16() & c;
-    } while (v >= n);
-    
-    return v;
-}
-
-
 void peformRAMTest()
 {
     uchar a;
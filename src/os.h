@@ -36,7 +36,7 @@ void outuint(uint v);
 int putchar(int c);
 char getkey();
 char scanKey();
-char scanKeyMatrix(char hold);
+uchar keyRows();
 void setcursor(char x, char y);
 void cls();
 void clsc(uchar c);
@@ -45,10 +45,13 @@ void initModel();
 void uninitModel();
 void pause();
 void setStack();
+uchar* ramTop();
 void revertStack();
-void enableInterrups();
+void enableInterrupts();
+void disableInterrupts();
 
 void outs(const char* s);
+void blitText(char x, char y, const char* s, uchar n);
 void outsWide(const char* s);
 void printf_simple(const char* f, ...);
 int sprintf_simple(char* buf, const char* f, ...);
@@ -63,16 +66,19 @@ uchar ramTest(uchar a, uchar n);
 typedef void (*IdleHandler)(uchar);
 void setIdleHandler(IdleHandler h, uchar d);
 
-void srand(uint v);
-unsigned int rand16();
-uint randn(uint n); // 16 bit version
-uchar randc(uchar n); // 8 bit version
 void peformRAMTest();
 
 extern uchar TRSModel;
+extern uchar useSVC;
+extern uchar hasDOS;
 extern uchar TRSMemory;
 extern uchar* TRSMemoryFail;
+extern uint cpuKHz;
+#ifdef COLS80
+#define cols80  COLS80
+#else
 extern uchar cols80;
+#endif
 extern unsigned int scrollPos;
 extern unsigned int cursorPos;
 extern uchar* vidRam;
@@ -0,0 +1,202 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include "defs.h"
+#include "os.h"
+#include "arena.h"
+#include "ovl.h"
+
+// bounds of _GEN, see crt0
+extern uchar genBase[];
+extern uchar heapBase[];
+
+// loaded with the program
+static uchar ovlResident = TRUE;
+
+#if MODEL == 1
+
+static void tapeOn() __naked
+{
+    __asm
+        xor  a          // drive 1
+        call 0x0212     // select, motor on
+        jp   0x0296     // find leader and sync
+    __endasm;
+}
+
+static uchar tapeByte() __naked
+{
+    __asm
+        call 0x0235
+        ld   l,a
+        ret
+    __endasm;
+}
+
+static void tapeOff() __naked
+{
+    __asm
+        jp   0x01f8     // motor off
+    __endasm;
+}
+
+static BOOL tapeLoad()
+{
+    // SYSTEM tape, as made by mksys. blocks of 0x3c, length (0 for 256),
+    // address, data and checksum, then 0x78 and the entry address.
+    // only blocks within _GEN are accepted, in case of the wrong tape.
+    
+    uchar* p;
+    uchar n, c, ck;
+    BOOL ok = TRUE;
+
+    lastLine();
+    getSingleChar("Ready APSGEN tape, press ENTER");
+
+    disableInterrupts();
+    tapeOn();
+
+    // 0x55 and the name
+    for (n = 0; n < 7; ++n) tapeByte();
+
+    while ((c = tapeByte()) == 0x3c)
+    {
+        n = tapeByte();
+        c = tapeByte();
+        p = (uchar*)(c | (tapeByte() << 8));
+        ck = c + ((uint)p >> 8);
+
+        if (p < genBase || p + (n ? n : 256) > heapBase)
+        {
+            ok = FALSE;
+            break;
+        }
+
+        do
+        {
+            c = tapeByte();
+            *p++ = c;
+            ck += c;
+        } while (--n);
+
+        if (tapeByte() != ck)
+        {
+            ok = FALSE;
+            break;
+        }
+    }
+
+    tapeOff();
+    enableInterrupts();
+    return ok && c == 0x78;
+}
+
+#elif defined(MODEL)
+
+#if MODEL == 4
+static const char ovlFile[] = "APSGEN4/CMD\r";
+#else
+static const char ovlFile[] = "APSGEN3/CMD\r";
+#endif
+
+static uchar fcb[32];
+
+static BOOL dosLoad(const char* spec) __naked
+{
+    // @FSPEC and @LOAD, Z if ok.
+    // a Model 4 is under DOS 6, see `getModel'.
+    __asm
+        pop  bc         // ret
+        pop  hl         // spec
+        push hl
+        push bc
+        push ix
+        push iy
+        ld   de,#_fcb
+        ld   a,(_TRSModel)
+        cp   #4
+        jr   c,.dl5
+        ld   a,#78      // @FSPEC
+        rst  0x28
+        jr   nz,.dl9
+        ld   de,#_fcb
+        ld   a,#76      // @LOAD
+        rst  0x28
+        jr   .dl9
+.dl5:
+        call 0x441c     // @FSPEC
+        jr   nz,.dl9
+        ld   de,#_fcb
+        call 0x4430     // @LOAD
+.dl9:
+        ld   l,#0
+        jr   nz,.dl10
+        inc  l
+.dl10:
+        pop  iy
+        pop  ix
+        ret
+    __endasm;
+}
+
+#endif // MODEL
+
+BOOL ovlLoad()
+{
+    // the generator in place and the arena after it.
+    // return FALSE if it cannot be loaded.
+
+#ifdef MODEL
+    if (!ovlResident)
+    {
+#if MODEL == 1
+        if (!tapeLoad()) return FALSE;
+#else
+        if (!dosLoad(ovlFile)) return FALSE;
+#endif
+        ovlResident = TRUE;
+    }
+#endif
+
+    arenaInit();
+    return TRUE;
+}
+
+void ovlDiscard()
+{
+    // the dungeon is made, nothing calls the generator until
+    // the next `ovlLoad'.
+    // the generic build may be on tape or disk, so it is kept.
+#ifdef MODEL
+    ovlResident = FALSE;
+    arenaReset(genBase);
+#endif
+}
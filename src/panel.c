@@ -0,0 +1,161 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include <ctype.h>
+#include "defs.h"
+#include "os.h"
+#include "plot.h"
+#include "rect.h"
+#include "game.h"
+#include "panel.h"
+
+// text as on screen, one line per field
+static char panel[PANEL_FIELDS][PANEL_W];
+
+// next field for `panelTask', PANEL_FIELDS when up to date
+static uchar panelNext = PANEL_FIELDS;
+
+static uchar* panelAddr(uchar field)
+{
+    return vidaddr((cols80 ? 80 : 64) - PANEL_W, field);
+}
+
+void panelReset()
+{
+    // blank all fields, eg for a new game
+    memset(panel, ' ', sizeof(panel));
+    panelNext = PANEL_FIELDS;
+}
+
+void panelRedraw()
+{
+    // the screen has been cleared, put the panel back
+    
+    uchar i, j;
+    char* p;
+    uchar* m;
+
+    for (i = 0; i < PANEL_FIELDS; ++i)
+    {
+        m = panelAddr(i);
+        p = panel[i];
+        for (j = 0; j < PANEL_W; ++j) *m++ = *p++;
+        VIDWRITES(PANEL_W);
+    }
+}
+
+void panelSet(uchar field, const char* s)
+{
+    // set field text, writing only the changes.
+    // text is upper case, so no need to check for lower case video.
+    
+    uchar j;
+    char c;
+    char* p = panel[field];
+    uchar* m = panelAddr(field);
+
+    for (j = 0; j < PANEL_W; ++j)
+    {
+        c = ' ';
+        if (*s) c = toupper(*s++);
+        if (*p != c)
+        {
+            *p = c;
+            *m = c;
+            VIDWRITES(1);
+        }
+        ++p;
+        ++m;
+    }
+}
+
+static void panelf(uchar field, const char* f, int v)
+{
+    char buf[32];
+    sprintf_simple(buf, f, v);
+    panelSet(field, buf);
+}
+
+static void panelField(uchar field)
+{
+    // show the player's state for `field', if it is one of those.
+    // fields that have not changed cost no video writes
+    
+    uchar r;
+
+    switch (field)
+    {
+    case pnl_room:
+        r = player.room;
+        if (r) r = roomNo(rooms + (r-1));
+        panelf(pnl_room, "ROOM NO. %d", r);
+        break;
+    case pnl_wounds:
+        panelf(pnl_wounds, "WOUNDS: %d%%", 100 - player.wounds);
+        break;
+    case pnl_fatigue:
+        panelf(pnl_fatigue, "FATIGUE: %d%%", 100 - player.fatigue);
+        break;
+    case pnl_weight:
+        panelf(pnl_weight, "WGT: %d LBS", player.weight);
+        break;
+    case pnl_arrows:
+        panelf(pnl_arrows, "ARROWS: %d", player.arrows);
+        break;
+    case pnl_magic:
+        panelf(pnl_magic, "MAG AR: %d", player.magic_arrows);
+        break;
+    case pnl_total:
+        panelf(pnl_total, "TOTAL SLAIN: %d", player.slain);
+        break;
+    }
+}
+
+void panelUpdate()
+{
+    // show the player's state now
+    uchar i;
+    for (i = 0; i < PANEL_FIELDS; ++i) panelField(i);
+}
+
+void panelLater()
+{
+    // have `panelTask' show the player's state
+    panelNext = 0;
+}
+
+BOOL panelTask()
+{
+    // one field per slice
+    if (panelNext >= PANEL_FIELDS) return FALSE;
+    panelField(panelNext++);
+    return TRUE;
+}
@@ -0,0 +1,72 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#ifndef __panel_h__
+#define __panel_h__
+
+/* status panel.
+ *
+ * The panel is the last PANEL_W columns of the screen, one field per
+ * line. Each field keeps the text last written, so an update only
+ * writes the characters that have changed. On the 64 column screen
+ * the dungeon view is narrowed to make room.
+ *
+ * `panelUpdate' shows the player's state at once, `panelLater' leaves
+ * it to `panelTask' a field at a time when idle (see task.h).
+ */
+
+#define PANEL_W         16
+
+enum PanelField
+{
+    pnl_room = 0,
+    pnl_wounds,
+    pnl_fatigue,
+    pnl_weight,
+    pnl_slain,          // MONSTER SLAIN!
+    pnl_attack,         // CRUNCH!
+    pnl_defend,         // SHIELD HIT!
+    pnl_arrows,
+    pnl_magic,
+    pnl_monster,
+    pnl_total,
+    pnl_info,
+    PANEL_FIELDS,
+};
+
+void panelReset();
+void panelRedraw();
+void panelSet(uchar field, const char* s);
+void panelUpdate();
+void panelLater();
+BOOL panelTask();
+
+#endif // __panel_h__
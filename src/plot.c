@@ -72,6 +72,7 @@ void plot(uchar x, uchar y, uchar c)
         *m = v | mask;
     else
         *m = v & ~mask;
+    VIDWRITES(1);
 }
 
 char getPixel(uchar x, uchar y)
@@ -134,6 +135,7 @@ void plotSpan(uchar x, uchar y, uchar n, uchar c)
                 *m = v | rightCol[q];
             else
                 *m = v & ~rightCol[q];
+            VIDWRITES(1);
             ++m;
             ++x;
             --n;
@@ -151,6 +153,7 @@ void plotSpan(uchar x, uchar y, uchar n, uchar c)
                 *m = v | mask;
             else
                 *m = v & ~mask;
+            VIDWRITES(1);
 
             ++m;
             ++x;
@@ -164,6 +167,7 @@ void plotSpan(uchar x, uchar y, uchar n, uchar c)
                 *m = v | leftCol[q];
             else
                 *m = v & ~leftCol[q];
+            VIDWRITES(1);
         }
     }
 }
@@ -195,6 +199,7 @@ void plotSpan2(uchar x, uchar y, uchar n)
     q = 64;
     if (cols80) q = 80;
     if (x + n > q) n = q - x;
+    VIDWRITES(n);
 
     while (n)
     {
@@ -262,6 +267,7 @@ void plotVLine(uchar x, uchar y1, uchar y2, uchar c)
         *m = v | mask;
     else
         *m = v & ~mask;
+    VIDWRITES(1);
 
     dm = 64;
     if (cols80) dm += 80 - 64;
@@ -276,6 +282,7 @@ void plotVLine(uchar x, uchar y1, uchar y2, uchar c)
             *m = v | q;
         else
             *m = v & ~q;
+        VIDWRITES(1);
     }
 
     if (y2)
@@ -293,6 +300,7 @@ void plotVLine(uchar x, uchar y1, uchar y2, uchar c)
             *m = v | mask;
         else
             *m = v & ~mask;
+        VIDWRITES(1);
     }
     
 }
@@ -332,6 +340,7 @@ void plotVLine2(uchar x, uchar y1, uchar y2)
     }
 
     if (*m < 0) *m |= mask; else *m = mask;
+    VIDWRITES(1);
 
     // unroll cases
     if (cols80)
@@ -341,6 +350,7 @@ void plotVLine2(uchar x, uchar y1, uchar y2)
             y2 -= 3;
             m += 80;
             *m = 0x80 + 63; // allcols
+            VIDWRITES(1);
         }
     }
     else
@@ -350,6 +360,7 @@ void plotVLine2(uchar x, uchar y1, uchar y2)
             y2 -= 3;
             m += 64;
             *m = 0x80 + 63; // allcols
+            VIDWRITES(1);
         }
     }
 
@@ -360,6 +371,7 @@ void plotVLine2(uchar x, uchar y1, uchar y2)
         mask = 0x80 + 1+2; // leftcol0+rightcol0
         if (y2 > 1) mask |= 4+8; //leftcol1+rightcol1
         if (*m < 0) *m |= mask; else *m = mask;        
+        VIDWRITES(1);
     }
 }
 
@@ -513,49 +525,86 @@ void drawRLE(char x, char y, const uchar* dp, uchar c)
     }
 }
 
-void moveRLE(char x, char y, const uchar* dp, signed char dx)
+uchar spriteCells(char x, char y, const CSprite* sp, uchar** cell, uchar* mask)
 {
-    // move left or right according to dx. dx = +/-1 or 0
-    // moves RLE sprite from (x,y) to (x-1, y) if `dx=-1`
-    // or from (x,y) to (x+1, y) if dx=1.
+    // find the cells covered by compiled sprite with hotspot at (x,y)
+    // the sprite has a pre-shifted cell image for each pixel phase
+    // so each cell just has a mask to set.
+    //
+    // write the video address and mask of each cell on screen to
+    // `cell' and `mask'. return the number of cells.
+    // there is room for SPRITE_SAVE, sprites.h is checked against it
+    // in dungeon.c.
 
-    // plot run-line encoded (RLE) sprite, colour c
-    // sprite format is made up of a sequence of skip/draw nibbles:
-    // <skip-draw> ... <0> <flyback>
-    // <skip-draw> ... <0> <flyback>
-    // ...
-    // 0x00
+    const uchar* dp;
+    uchar q, w, h, i, m, cols, rows, n;
+    signed char cx, k;
+    uchar* vp;
 
-    uchar pair;
+    x += sp->ox;
+    y += sp->oy;
+    if (y < 0) return 0; // not within screen
 
-    for (;;)
+    q = div3tab[(uchar)y];
+
+    // select image for the phase (y%3)*2 + (x&1)
+    dp = sp->img[((y - q - q - q) << 1) + (x & 1)];
+    w = *dp++;
+    h = *dp++;
+
+    cols = 64;
+    rows = 16;
+    if (cols80)
     {
-        // if moving right, set first pixel of row
-        if (dx > 0) plot(x, y, 0);
+        cols = 80;
+        rows = 24;
+    }
 
-        // adjust start of line span
-        x += dx;
+    // start of row, x can be off the left
+    vp = vidaddr(0, q);
+    cx = x >> 1;
+    n = 0;
 
-        // plot each line span of sprite
-        while (pair = *dp++)
+    while (h && q < rows)
+    {
+        --h;
+        for (i = 0; i < w; ++i)
         {
-            uchar t = pair >> 4;
-            plotSpan(x, y, t, 0); // reset skip
-            x += t;
-
-            t = pair & 0xf;
-            plotSpan(x, y, t, 1); // set region
-            x += t;
+            m = dp[i];
+            k = cx + i;
+            if (m && k >= 0 && k < cols)
+            {
+                *cell++ = vp + k;
+                *mask++ = m;
+                ++n;
+            }
         }
-
-        // if moving left, reset last pixel of row
-        if (dx < 0)
-            plot(x, y, 0);
-        
-        // flyback with adjustment
-        if (!*dp) break;
-        x -= (*dp++ + dx);
-        ++y;
+        dp += w;
+        vp += cols;
+        ++q;
     }
+    return n;
 }
 
+void drawSprite(char x, char y, const CSprite* sp, uchar c)
+{
+    // plot compiled sprite, colour c
+    // like `drawRLE', this does not reset the empty parts of the sprite.
+
+    uchar* cell[SPRITE_SAVE];
+    uchar mask[SPRITE_SAVE];
+    uchar n, i;
+    signed char v;
+
+    n = spriteCells(x, y, sp, cell, mask);
+    for (i = 0; i < n; ++i)
+    {
+        v = *cell[i];
+        if (v >= 0) v = 0x80;
+        if (c)
+            *cell[i] = v | mask[i];
+        else
+            *cell[i] = v & ~mask[i];
+        VIDWRITES(1);
+    }
+}
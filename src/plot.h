@@ -31,11 +31,31 @@
 
 extern const unsigned char div3tab[];
 
+// compiled sprite, see tools/sprc
+typedef struct
+{
+    signed char         ox;     // offset of top left from hotspot
+    signed char         oy;
+    const uchar*        img[6]; // cell image by phase (y%3)*2 + (x&1)
+} CSprite;
+
+// max cells covered by any sprite in sprites.h
+#define SPRITE_SAVE     8
+
+#ifdef STANDALONE
+// host build counts video writes, see host.c
+extern unsigned long vidWrites;
+#define VIDWRITES(_n)  (vidWrites += (_n))
+#else
+#define VIDWRITES(_n)
+#endif
+
 void plot(uchar x, uchar y, uchar c);
 void plotSpan(uchar x0, uchar y, uchar n, uchar c);
 void plotSpan2(uchar x, uchar y, uchar n);
 void drawRLE(char x, char y, const uchar* dp, uchar c);
-void moveRLE(char x, char y, const uchar* dp, signed char dx);
+uchar spriteCells(char x, char y, const CSprite* sp, uchar** cell, uchar* mask);
+void drawSprite(char x, char y, const CSprite* sp, uchar c);
 char getPixel(uchar x, uchar y);
 
 void plotHLine(uchar x1, uchar y, uchar x2, uchar c);
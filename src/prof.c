@@ -0,0 +1,89 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include <string.h>
+
+#include "defs.h"
+#include "os.h"
+#include "file.h"
+#include "kbd.h"
+#include "prof.h"
+
+// samples per code page, counted by `rtcISR'
+uint profHist[256];
+
+BOOL profKey()
+{
+    // either shift, row 7 of the matrix
+    return ((cols80 ? KBBASE80 : KBBASE)[0x80] & 3) != 0;
+}
+
+void profDump()
+{
+    // samples arriving while we write are lost with the clear.
+    // without a DOS (a cassette Model I or III) list them instead.
+    uint i;
+#if defined(MODEL) && MODEL == 1
+    // the cassette build has no file.c
+    BOOL ok = FALSE;
+#else
+    File f;
+    BOOL ok = hasDOS && fileOpen(&f, "PROF/DAT", FILE_WRITE);
+    
+    if (ok)
+    {
+        ok = fileWrite(&f, profHist, sizeof(profHist));
+        ok = fileClose(&f) && ok;
+    }
+#endif
+
+    if (ok)
+    {
+        lastLine();
+        outs("Profile written to PROF/DAT");
+    }
+    else
+    {
+        cls();
+        for (i = 0; i < 256; ++i)
+        {
+            if (profHist[i])
+            {
+                printf_simple("%x:", (int)i);
+                outuint(profHist[i]);
+                outchar(' ');
+            }
+        }
+    }
+
+    while (!kbdGet()) ;
+    memset(profHist, 0, sizeof(profHist));
+}
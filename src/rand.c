@@ -0,0 +1,104 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include "defs.h"
+#include "rand.h"
+#include "fastmath.h"
+
+// xorshift with the triplet 7,9,8, period 65535.
+// the Z80 version is John Metcalf's, the C version is its twin for the
+// host build and must give the same sequence.
+static uint seed = 1;
+
+void srand(uint v)
+{
+    // zero is the one state xorshift never leaves
+    seed = v ? v : 1;
+}
+
+void randStir()
+{
+    // change the seed a bit, eg. while waiting for a key
+    if (!++seed) seed = 1;
+}
+
+#ifdef STANDALONE
+
+unsigned int rand16()
+{
+    uint x = seed;
+    x ^= (x << 7) & 0xffff;
+    x ^= x >> 9;
+    x ^= (x << 8) & 0xffff;
+    seed = x;
+    return x;
+}
+
+#else
+
+unsigned int rand16() __naked
+{
+    __asm
+        ld   hl,(_seed)
+        ld   a,h
+        rra
+        ld   a,l
+        rra
+        xor  h
+        ld   h,a
+        ld   a,l
+        rra
+        ld   a,h
+        rra
+        xor  l
+        ld   l,a
+        xor  h
+        ld   h,a
+        ld   (_seed),hl
+        ret
+    __endasm;
+}
+
+#endif
+
+uint randn(uint n)
+{
+    // random [0,n-1]
+    // 16 bit version, scaled so there are no retries
+    return ((unsigned long)rand16() * n) >> 16;
+}
+
+uchar randc(uchar n)
+{
+    // random [0,n-1]
+    // 8 bit version, scaled so there are no retries
+    return mul8(rand16() >> 8, n) >> 8;
+}
@@ -0,0 +1,180 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include "defs.h"
+#include "os.h"
+#include "kbd.h"
+#include "rtc.h"
+#include "fastmath.h"
+#ifdef SFX
+#include "sfx.h"
+#endif
+#ifdef PROFILE
+#include "prof.h"
+#endif
+
+// is the interrupt hooked?
+uchar rtcOn;
+
+// the JP we patched and where it went
+static uchar* rtcVector;
+static uint rtcChain;
+
+// game ticks at TICK_HZ
+static volatile uint ticks;
+static uchar rtcOdd;
+
+// delay loops per tick at 24 T-states each, for when not hooked.
+// kHz*1000/(30*24) is kHz*25/18, 2464 on the Model I.
+static uint tickLoops;
+
+void rtcTick()
+{
+    // called from the interrupt, keep it short
+    kbdScan();
+
+    // Model 4 is 60Hz
+    if (TRSModel >= 4 && (rtcOdd ^= 1)) return;
+    ++ticks;
+
+#ifdef SFX
+    // a step of any sound effect
+    sfxTick();
+#endif
+}
+
+uint getTicks()
+{
+    // read twice in case the interrupt changes it half way
+    uint t;
+    do t = ticks; while (t != ticks);
+    return t;
+}
+
+static void delayLoop(uint n) __naked
+{
+    // 24 T-states per loop
+    __asm
+        pop  de
+        pop  bc         // n
+        push bc
+        push de
+.dl1:
+        dec  bc         // 6
+        ld   a,b        // 4
+        or   c          // 4
+        jp   nz,.dl1    // 10
+        ret
+    __endasm;
+}
+
+void rtcIdle()
+{
+    // called when the game has nothing to do. 
+    // without the interrupt, wait a tick and count it.
+    if (!rtcOn)
+    {
+        delayLoop(tickLoops);
+        ++ticks;
+    }
+}
+
+static void rtcISR() __naked
+{
+    // the Model III and 4 RTC interrupt shows as bit 2 of port 0xE0
+    // low. the old handler reads port 0xEC which clears it.
+    __asm
+        push af
+        push bc
+        push de
+        push hl
+        push iy
+        in   a,(#0xe0)
+        bit  2,a
+        jr   nz,.ri1
+#ifdef PROFILE
+        // count the page of the interrupted PC, above our 5 pushes
+        ld   hl,#11
+        add  hl,sp
+        ld   l,(hl)
+        ld   h,#0
+        add  hl,hl
+        ld   de,#_profHist
+        add  hl,de
+        inc  (hl)
+        jr   nz,.ri2
+        inc  hl
+        inc  (hl)
+.ri2:
+#endif
+        call _rtcTick
+.ri1:
+        pop  iy
+        pop  hl
+        pop  de
+        pop  bc
+        pop  af
+        push hl
+        ld   hl,(_rtcChain)
+        ex   (sp),hl        // chain to old handler
+        ret
+    __endasm;
+}
+
+void rtcInit()
+{
+    // RST 38 goes through a JP at 0x4012 on the Model III (ROM and
+    // LDOS), LS-DOS 6 has its JP at 0x0038 itself.
+
+    tickLoops = cpuKHz + mul16x8(div16x8(cpuKHz, 18), 7);
+    if (TRSModel < 3) return;
+
+    rtcVector = (uchar*)(TRSModel >= 4 ? 0x0038 : 0x4012);
+    if (*rtcVector != 0xc3) return; // not a JP, leave alone
+
+    disableInterrupts();
+    rtcChain = *(uint*)(rtcVector + 1);
+    *(uint*)(rtcVector + 1) = (uint)rtcISR;
+    rtcOn = TRUE;
+    enableInterrupts();
+}
+
+void rtcDone()
+{
+    // must unhook before returning to DOS
+    if (rtcOn)
+    {
+        disableInterrupts();
+        *(uint*)(rtcVector + 1) = rtcChain;
+        rtcOn = FALSE;
+        enableInterrupts();
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include <string.h>
+#include "defs.h"
+#include "rtc.h"
+#include "sched.h"
+
+typedef struct
+{
+    SchedFn     fn;     // 0 if free
+    uint        next;   // tick due
+    uchar       period;
+} SchedEvent;
+
+static SchedEvent events[SCHED_MAX];
+
+void schedInit()
+{
+    memset(events, 0, sizeof(events));
+}
+
+uchar schedAdd(SchedFn fn, uchar period)
+{
+    // run `fn' every `period' ticks from now.
+    // return id for `schedRemove' or 0 if full.
+    
+    uchar i;
+    SchedEvent* e = events;
+    
+    for (i = 0; i < SCHED_MAX; ++i)
+    {
+        if (!e->fn)
+        {
+            e->fn = fn;
+            e->period = period;
+            e->next = getTicks() + period;
+            return i + 1;
+        }
+        ++e;
+    }
+    return 0;
+}
+
+void schedRemove(uchar id)
+{
+    if (id) events[id-1].fn = 0;
+}
+
+void schedRun()
+{
+    // run everything due
+    
+    uchar i, n;
+    uint now = getTicks();
+    SchedEvent* e = events;
+
+    for (i = 0; i < SCHED_MAX; ++i)
+    {
+        n = SCHED_CATCHUP;
+        while (e->fn && (int)(now - e->next) >= 0)
+        {
+            if (!n--)
+            {
+                // too far behind, start again from now
+                e->next = now + e->period;
+                break;
+            }
+            e->next += e->period;
+            (*e->fn)();
+        }
+        ++e;
+    }
+}
@@ -0,0 +1,164 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include "defs.h"
+#include "os.h"
+#include "rtc.h"
+#include "sfx.h"
+
+// must be a power of 2
+#define SFX_QSIZE       16
+
+typedef struct
+{
+    uint    period;     // for `__tone', scaled to `cpuKHz'
+    uchar   cycles;
+} SfxQ;
+
+// written by `sfxPlay', read by `sfxTick', maybe in the interrupt
+static SfxQ sfxQ[SFX_QSIZE];
+static volatile uchar sfxHead;
+static volatile uchar sfxTail;
+
+// steps longer than SFX_TICK_MS are split over ticks. low tones need
+// the longer steps to get two whole cycles.
+
+// arrow or blow landing
+const SfxStep sfxThwunk[] =
+{
+    SFX_TONE(220, 10),
+    SFX_TONE(160, 13),
+    SFX_TONE(110, 18),
+    SFX_END
+};
+
+// a hit, low and rough
+const SfxStep sfxCrunch[] =
+{
+    SFX_TONE(180, 12),
+    SFX_TONE(90, 22),
+    SFX_TONE(230, 9),
+    SFX_TONE(120, 17),
+    SFX_END
+};
+
+// ringing metal
+const SfxStep sfxShieldHit[] =
+{
+    SFX_TONE(1500, 6),
+    SFX_TONE(2000, 5),
+    SFX_REST,
+    SFX_TONE(1500, 4),
+    SFX_TONE(1500, 3),
+    SFX_END
+};
+
+static void sfxTone(uint period, uchar cycles) __naked
+{
+    // `__tone' wants HL=period, DE=cycles
+    __asm
+        ld   hl,#2
+        add  hl,sp
+        ld   e,(hl)
+        inc  hl
+        ld   d,(hl)     // period
+        inc  hl
+        ld   a,(hl)     // cycles
+        ex   de,hl
+        ld   e,a
+        ld   d,#0
+        jp   __tone
+    __endasm;
+}
+
+void sfxPlay(const SfxStep* fx)
+{
+    // queue the steps of `fx', as many as fit
+    uchar h = sfxHead;
+    uchar n;
+    uchar c;
+    uchar m;
+    uint p;
+
+    for (; fx->pscale; ++fx)
+    {
+        // less the loop overhead, as `playMelody'
+        p = (((unsigned long)cpuKHz*fx->pscale) >> 14) - 30;
+
+        // no more than a tick's worth in each
+        c = fx->cycles;
+        do
+        {
+            n = (h + 1) & (SFX_QSIZE-1);
+            if (n == sfxTail) break; // full
+
+            m = c;
+            if (m > fx->most) m = fx->most;
+            sfxQ[h].period = p;
+            sfxQ[h].cycles = m;
+            c -= m;
+            h = n;
+        } while (c);
+        if (n == sfxTail) break;
+    }
+    sfxHead = h;
+}
+
+void sfxStop()
+{
+    // the interrupt also moves the tail
+    disableInterrupts();
+    sfxTail = sfxHead;
+    enableInterrupts();
+}
+
+void sfxTick()
+{
+    // play the next step, once a tick from the interrupt
+    uchar t = sfxTail;
+    if (t != sfxHead)
+    {
+        // `__tone' plays one more cycle than asked
+        if (sfxQ[t].cycles) sfxTone(sfxQ[t].period, sfxQ[t].cycles - 1);
+        sfxTail = (t + 1) & (SFX_QSIZE-1);
+    }
+}
+
+BOOL sfxTask()
+{
+    // without the interrupt, play steps while idle. a rest returns
+    // FALSE, so the game loop waits a tick in `rtcIdle'.
+    uchar t = sfxTail;
+    if (rtcOn || t == sfxHead) return FALSE;
+
+    sfxTick();
+    return sfxQ[t].cycles != 0;
+}
@@ -0,0 +1,80 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#ifndef __sfx_h__
+#define __sfx_h__
+
+/* queued sound effects.
+ *
+ * The beeper needs the CPU for every edge, so no tone can play behind
+ * the game. Instead an effect is a short program of tone steps, and
+ * one step of a few milliseconds is played each game tick, from the
+ * RTC interrupt on the Model III and 4 (see rtc.c). The game stops
+ * only for the steps, not for the gaps between them.
+ *
+ * The Model I has no interrupt, so `sfxTask' plays the steps back to
+ * back when the game is idle (see task.h).
+ *
+ * Nothing plays an effect until there is combat, so the engine is only
+ * built with `make SFX=1'.
+ */
+
+// the most a tick plays, inside the 16.7ms interrupt of the Model 4.
+// longer steps are split over ticks, so tones must be >= 84Hz for a
+// cycle to fit.
+#define SFX_TICK_MS     12
+
+typedef struct
+{
+    uint    pscale;     // 125*16384/f, see sound.h. 0 ends
+    uchar   cycles;     // of the tone, 0 for a tick of silence
+    uchar   most;       // cycles in SFX_TICK_MS
+} SfxStep;
+
+// 14 fractional bits rather than the 16 of a melody note, so that
+// tones down to 32Hz fit. steps are a whole number of cycles, to
+// the nearest.
+#define SFX_TONE(_f, _ms)   { (uint)(125*16384.0/(_f) + 0.5), \
+                              (uchar)((_f)*(_ms)/1000.0 + 0.5), \
+                              (uchar)((_f)*SFX_TICK_MS/1000) }
+#define SFX_REST            { 1, 0, 0 }
+#define SFX_END             { 0, 0, 0 }
+
+extern const SfxStep sfxThwunk[];
+extern const SfxStep sfxCrunch[];
+extern const SfxStep sfxShieldHit[];
+
+void sfxPlay(const SfxStep* fx);
+void sfxStop();
+void sfxTick();
+BOOL sfxTask();
+
+#endif // __sfx_h__
@@ -29,139 +29,67 @@
  *  contact@voidware.com
  */
 
-#include <ctype.h>
-
 #include "defs.h"
 #include "os.h"
 #include "sound.h"
 
+// notes scaled at a time, see `playMelody'
+#define MELODY_RUN      32
 
-#define BASE_TSTATES_M1 221750L
-#define BASE_TSTATES_M3 257230L
-
-// frequencies for notes.
-// "A" above middle C is 440Hz.
-// f = 440 * (2^(k/12)) where k is the number of tones above or below
-// so middle "C" is 9 tones down and therefore Fc = 440*2^(-9/12) = 261.63
-
-// standard octave
-#define NOTE_C  	261.625565290
-#define NOTE_CS 	277.182631135    
-#define NOTE_D  	293.664768100      
-#define NOTE_DS 	311.126983881    
-#define NOTE_E          329.627557039   
-#define NOTE_F  	349.228231549      
-#define NOTE_FS 	369.994422674     
-#define NOTE_G  	391.995436072       
-#define NOTE_GS 	415.304697513       
-#define NOTE_A  	440.000000000      
-#define NOTE_AS 	466.163761616   
-#define NOTE_B  	493.883301378     
-
-#define RND(_x)     ((int)((_x) + 0.5))
-#define TSTATE1(_n)  RND(BASE_TSTATES_M1/_n)
-#define TSTATE3(_n)  RND(BASE_TSTATES_M3/_n)
-
-typedef struct
-{
-    char                _note;
-    unsigned int        _freq;
-    unsigned int        _tstatesM1;
-    unsigned int        _tstatesM3;
-} Note;
-
-static const Note notes[] =
-{
-    { 'C', RND(NOTE_C), TSTATE1(NOTE_C), TSTATE3(NOTE_C) },
-    { 'C', RND(NOTE_CS), TSTATE1(NOTE_CS), TSTATE3(NOTE_CS) },
-    { 'D', RND(NOTE_D), TSTATE1(NOTE_D), TSTATE3(NOTE_D) },
-    { 'D', RND(NOTE_DS), TSTATE1(NOTE_DS), TSTATE3(NOTE_DS) },
-    { 'E', RND(NOTE_E), TSTATE1(NOTE_E), TSTATE3(NOTE_E) },
-    { 'F', RND(NOTE_F), TSTATE1(NOTE_F), TSTATE3(NOTE_F) },
-    { 'F', RND(NOTE_FS), TSTATE1(NOTE_FS), TSTATE3(NOTE_FS) },
-    { 'G', RND(NOTE_G), TSTATE1(NOTE_G), TSTATE3(NOTE_G) },
-    { 'G', RND(NOTE_GS), TSTATE1(NOTE_GS), TSTATE3(NOTE_GS) },
-    { 'A', RND(NOTE_A), TSTATE1(NOTE_A), TSTATE3(NOTE_A) },
-    { 'A', RND(NOTE_AS), TSTATE1(NOTE_AS), TSTATE3(NOTE_AS) },
-    { 'B', RND(NOTE_B), TSTATE1(NOTE_B), TSTATE3(NOTE_B) },
-};
-
-// play melodies. eg:
+static MelodyNote melodyRun[MELODY_RUN + 1];
 
-#if 0
-static int divs(int a, uint b)
+static void melodyLoop(MelodyNote* m) __naked
 {
-    // bogus routine to divide using only unsigned int
-    return a >= 0 ? (int)(((uint)a)/b) : -(int)(((uint)(-a))/b);
+    // feed `__tone' note after note with interrupts off, so there is
+    // no gap between them. the ending `__rti' enables them again.
+    __asm
+        ld   hl,#2
+        add  hl,sp
+        ld   c,(hl)
+        inc  hl
+        ld   b,(hl)     // m
+        di
+.ml1:
+        ld   a,(bc)
+        ld   e,a
+        inc  bc
+        ld   a,(bc)
+        ld   d,a        // cycles
+        inc  bc
+        or   e
+        jp   z,__rti    // end
+        ld   a,(bc)
+        ld   l,a
+        inc  bc
+        ld   a,(bc)
+        ld   h,a        // period
+        inc  bc
+        push bc
+        call __tone
+        pop  bc
+        jr   .ml1
+    __endasm;
 }
-#endif
 
-void playNotes(const char* m)
+void playMelody(const MelodyNote* m)
 {
-    // [A-G][#b]?[0-9]*
-    // + = up octave, - = down octave
-    // t sets initial tempo divider
-
-    const Note* n = 0;
-    uchar dt = 2;
-    uchar dt2 = 0;
-    uint tempo = 12;
-    char u = 0;
+    // the notes are scaled to this machine into `melodyRun' and
+    // played from there, so nothing is worked out between them.
+    // a longer melody pauses every MELODY_RUN notes to scale more.
+    
+    MelodyNote* p;
 
-    for (;;)
+    while (m->cycles)
     {
-        char c = *m++;
-
-        if (c >= 'A' && c <= 'G' || !c)
+        for (p = melodyRun; m->cycles && p < melodyRun + MELODY_RUN; ++p)
         {
-            if (n)
-            {
-                uint a, b;
-                char u2;
-                
-                if (dt2)
-                {
-                    dt = dt2;
-                    dt2 = 0;
-                }
-
-                a = dt*n->_freq;
-                b = TRSModel == 1 ? n->_tstatesM1 : n->_tstatesM3;
-                u2 = u;
-                while (u2 > 0)
-                {
-                    --u2;
-                    a <<= 1;
-                    b >>= 1;
-                }
-                while (u2 < 0)
-                {
-                    ++u2;
-                    a >>= 1;
-                    b <<= 1;
-                }
-                bit_sound(a/tempo, b - 30);
-            }
+            p->cycles = m->cycles;
 
-            if (!c) break;
-            for (n = notes; n->_note != c; ++n) ;
-        }
-        if (c == '#')
-            ++n;
-        if (c == 'b')
-            --n;
-        if (c == '+')
-            ++u;
-        if (c == '-')
-            --u;
-        if (isdigit(c))
-            dt2 = 10*dt2 + (c - '0');
-        if (c == 't')
-        {
-            tempo = dt2;
-            dt2 = 0;
+            // less the loop overhead
+            p->period = (((unsigned long)cpuKHz*m->period) >> 16) - 30;
+            ++m;
         }
+        p->cycles = 0;
+        melodyLoop(melodyRun);
     }
 }
-
-
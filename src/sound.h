@@ -32,8 +32,19 @@
 #ifndef __sound_h__
 #define __sound_h__
 
+// a note of a melody compiled by tools/melody (see melodies.txt).
+// `__beeper' takes 8 T-states per unit of period for a whole cycle,
+// so period = clock/(8f) = kHz*125/f. notes are compiled with
+// 125*65536/f, which `playMelody' scales by `cpuKHz' as it plays.
+// a note with 0 cycles ends the melody.
+typedef struct
+{
+    uint    cycles;
+    uint    period;
+} MelodyNote;
+
 extern void bit_sound(int duration, int frequency);
-extern void playNotes(const char* m);
+extern void playMelody(const MelodyNote* m);
 extern void explode_sound(int d);
 
 extern void warpsound(int length);
@@ -62,6 +62,12 @@ _bit_sound::
         ;; preserve the wide-char bits for model I
 __beeper::
           di
+          call __tone
+          jp   __rti
+
+        ;; as __beeper, but leave interrupts alone,
+        ;; for the RTC interrupt (see sfx.c)
+__tone::
           in   a,(#0xff)      ; current wide status (model I) inverted
           cpl                 ; flip. Thanks to gp2000 
           and  #0x40
@@ -115,7 +121,7 @@ __beeper::
 .be_end:
           pop  af
           out  (sndbit_port),a
-          jp   __rti
+          ret
 
         ;;;  explode_sound(int d)
 _explode_sound::
@@ -0,0 +1,86 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+/* RLE sprite definitions.
+ *
+ * These are not compiled into the game. tools/sprc reads this file and
+ * generates `sprites.h', containing the pre-shifted cell images that
+ * are actually drawn (see `drawSprite').
+ *
+ * sprite format is made up of a sequence of skip/draw nibbles:
+ * <skip-draw> ... <0> <flyback>
+ * <skip-draw> ... <0> <flyback>
+ * ...
+ * 0x00
+ *
+ * NAME_ORIGIN is the offset of the sprite top left from the creature
+ * position.
+ */
+
+#define playerSpriteE_ORIGIN -3,-1
+
+static const uchar playerSpriteE[] =
+{
+    0x04,0,1,
+    0x12,0,6,
+    0x04,0,
+    0,
+};
+
+#define playerSpriteW_ORIGIN -1,-1
+
+static const uchar playerSpriteW[] =
+{
+    0x04,0,6,
+    0x02,0,1,
+    0x14,0,
+    0,
+};
+
+#define playerSpriteN_ORIGIN -1,-1
+
+static const uchar playerSpriteN[] =
+{
+    0x02,0,4,
+    0x02,0x22,0,6,
+    0x02,0x22,0,
+    0,
+};
+
+#define playerSpriteS_ORIGIN -3,-1
+
+static const uchar playerSpriteS[] =
+{
+    0x02,0x22,0,6,
+    0x02,0x22,0,4,
+    0x02,0,
+    0,
+};
@@ -0,0 +1,185 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include "defs.h"
+#include "plot.h"
+#include "sprite.h"
+
+typedef struct
+{
+    const CSprite*      sp;     // 0 if not shown
+    char                x;
+    char                y;
+    uchar               n;      // cells covered
+    uchar*              cell[SPRITE_SAVE];
+    uchar               save[SPRITE_SAVE];  // cells underneath
+} SpriteSlot;
+
+static SpriteSlot slots[MAX_SPRITES];
+
+static uchar _merge(signed char v, uchar mask)
+{
+    // cell `v' with sprite `mask' on top
+    if (v >= 0) v = 0x80;
+    return v | mask;
+}
+
+static void _hide(SpriteSlot* s)
+{
+    uchar i;
+    for (i = 0; i < s->n; ++i) *s->cell[i] = s->save[i];
+    VIDWRITES(s->n);
+    s->n = 0;
+}
+
+static void _show(SpriteSlot* s)
+{
+    uchar mask[SPRITE_SAVE];
+    uchar i;
+
+    s->n = 0;
+    if (s->sp)
+    {
+        s->n = spriteCells(s->x, s->y, s->sp, s->cell, mask);
+        for (i = 0; i < s->n; ++i)
+        {
+            s->save[i] = *s->cell[i];
+            *s->cell[i] = _merge(s->save[i], mask[i]);
+        }
+        VIDWRITES(s->n);
+    }
+}
+
+static void _move(SpriteSlot* s, char x, char y, const CSprite* sp)
+{
+    // move the top sprite in `s' to its new place and shape.
+    // only cells that change are written, so a small step costs just
+    // the leading and trailing edges.
+
+    uchar* cell[SPRITE_SAVE];
+    uchar mask[SPRITE_SAVE];
+    uchar save[SPRITE_SAVE];
+    uchar n, i, j, v;
+    uchar* c;
+
+    n = 0;
+    if (sp) n = spriteCells(x, y, sp, cell, mask);
+
+    // what is underneath the new place. where it overlaps the old,
+    // this is what the old one saved.
+    for (i = 0; i < n; ++i)
+    {
+        c = cell[i];
+        v = *c;
+        for (j = 0; j < s->n; ++j)
+        {
+            if (s->cell[j] == c)
+            {
+                v = s->save[j];
+                break;
+            }
+        }
+        save[i] = v;
+    }
+
+    // put back the old cells no longer covered
+    for (j = 0; j < s->n; ++j)
+    {
+        c = s->cell[j];
+        for (i = 0; i < n; ++i) if (cell[i] == c) break;
+        if (i == n)
+        {
+            *c = s->save[j];
+            VIDWRITES(1);
+        }
+    }
+
+    // draw the new, writing only changes
+    for (i = 0; i < n; ++i)
+    {
+        c = cell[i];
+        v = _merge(save[i], mask[i]);
+        if (*c != v)
+        {
+            *c = v;
+            VIDWRITES(1);
+        }
+        s->cell[i] = c;
+        s->save[i] = save[i];
+    }
+
+    s->n = n;
+    s->sp = sp;
+    s->x = x;
+    s->y = y;
+}
+
+void spritesReset()
+{
+    // the screen has been redrawn, so nothing is shown.
+    // forget all the sprites without restoring.
+    uchar i;
+    for (i = 0; i < MAX_SPRITES; ++i)
+    {
+        slots[i].sp = 0;
+        slots[i].n = 0;
+    }
+}
+
+void spriteSet(uchar slot, char x, char y, const CSprite* sp)
+{
+    // show sprite `sp' at (x,y) in `slot', or hide if `sp' is 0.
+
+    SpriteSlot* s = slots + slot;
+    SpriteSlot* t;
+
+    // if nothing is shown above, move directly
+    t = slots + MAX_SPRITES;
+    while (--t != s) if (t->n) break;
+    if (t == s)
+    {
+        _move(s, x, y, sp);
+        return;
+    }
+
+    // take off sprites from the top down to this one
+    t = slots + MAX_SPRITES;
+    while (t != s) _hide(--t);
+    _hide(s);
+
+    s->sp = sp;
+    s->x = x;
+    s->y = y;
+
+    // and put them back on again
+    t = slots + MAX_SPRITES;
+    while (s != t) _show(s++);
+}
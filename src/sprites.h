@@ -0,0 +1,39 @@
+/* generated by tools/sprc from sprdef.h. do not edit */
+
+static const uchar playerSpriteE_0[] = { 3,1, 0x33, 0x33, 0x0C, };
+static const uchar playerSpriteE_1[] = { 4,1, 0x22, 0x33, 0x19, 0x04, };
+static const uchar playerSpriteE_2[] = { 3,2, 0x0C, 0x0C, 0x30, 0x03, 0x03, 0x00, };
+static const uchar playerSpriteE_3[] = { 4,2, 0x08, 0x0C, 0x24, 0x10, 0x02, 0x03, 0x01, 0x00, };
+static const uchar playerSpriteE_4[] = { 3,2, 0x30, 0x30, 0x00, 0x0C, 0x0C, 0x03, };
+static const uchar playerSpriteE_5[] = { 4,2, 0x20, 0x30, 0x10, 0x00, 0x08, 0x0C, 0x06, 0x01, };
+
+static const CSprite playerSpriteE = { -3, -1, { playerSpriteE_0, playerSpriteE_1, playerSpriteE_2, playerSpriteE_3, playerSpriteE_4, playerSpriteE_5, } };
+
+static const uchar playerSpriteW_0[] = { 3,1, 0x0C, 0x33, 0x33, };
+static const uchar playerSpriteW_1[] = { 4,1, 0x08, 0x26, 0x33, 0x11, };
+static const uchar playerSpriteW_2[] = { 3,2, 0x30, 0x0C, 0x0C, 0x00, 0x03, 0x03, };
+static const uchar playerSpriteW_3[] = { 4,2, 0x20, 0x18, 0x0C, 0x04, 0x00, 0x02, 0x03, 0x01, };
+static const uchar playerSpriteW_4[] = { 3,2, 0x00, 0x30, 0x30, 0x03, 0x0C, 0x0C, };
+static const uchar playerSpriteW_5[] = { 4,2, 0x00, 0x20, 0x30, 0x10, 0x02, 0x09, 0x0C, 0x04, };
+
+static const CSprite playerSpriteW = { -3, -1, { playerSpriteW_0, playerSpriteW_1, playerSpriteW_2, playerSpriteW_3, playerSpriteW_4, playerSpriteW_5, } };
+
+static const uchar playerSpriteN_0[] = { 3,1, 0x3C, 0x03, 0x3C, };
+static const uchar playerSpriteN_1[] = { 4,1, 0x28, 0x16, 0x29, 0x14, };
+static const uchar playerSpriteN_2[] = { 3,2, 0x30, 0x0C, 0x30, 0x03, 0x00, 0x03, };
+static const uchar playerSpriteN_3[] = { 4,2, 0x20, 0x18, 0x24, 0x10, 0x02, 0x01, 0x02, 0x01, };
+static const uchar playerSpriteN_4[] = { 3,2, 0x00, 0x30, 0x00, 0x0F, 0x00, 0x0F, };
+static const uchar playerSpriteN_5[] = { 4,2, 0x00, 0x20, 0x10, 0x00, 0x0A, 0x05, 0x0A, 0x05, };
+
+static const CSprite playerSpriteN = { -3, -1, { playerSpriteN_0, playerSpriteN_1, playerSpriteN_2, playerSpriteN_3, playerSpriteN_4, playerSpriteN_5, } };
+
+static const uchar playerSpriteS_0[] = { 3,1, 0x0F, 0x30, 0x0F, };
+static const uchar playerSpriteS_1[] = { 4,1, 0x0A, 0x25, 0x1A, 0x05, };
+static const uchar playerSpriteS_2[] = { 3,2, 0x3C, 0x00, 0x3C, 0x00, 0x03, 0x00, };
+static const uchar playerSpriteS_3[] = { 4,2, 0x28, 0x14, 0x28, 0x14, 0x00, 0x02, 0x01, 0x00, };
+static const uchar playerSpriteS_4[] = { 3,2, 0x30, 0x00, 0x30, 0x03, 0x0C, 0x03, };
+static const uchar playerSpriteS_5[] = { 4,2, 0x20, 0x10, 0x20, 0x10, 0x02, 0x09, 0x06, 0x01, };
+
+static const CSprite playerSpriteS = { -3, -1, { playerSpriteS_0, playerSpriteS_1, playerSpriteS_2, playerSpriteS_3, playerSpriteS_4, playerSpriteS_5, } };
+
+#define SPRITE_CELLS 8
@@ -0,0 +1,107 @@
+/**
+ *
+ *    _    __        _      __                           
+ *   | |  / /____   (_)____/ /_      __ ____ _ _____ ___ 
+ *   | | / // __ \ / // __  /| | /| / // __ `// ___// _ \
+ *   | |/ // /_/ // // /_/ / | |/ |/ // /_/ // /   /  __/
+ *   |___/ \____//_/ \__,_/  |__/|__/ \__,_//_/    \___/ 
+ *                                                       
+ *  Copyright () Voidware 2018.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ * 
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ * 
+ *  THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ * 
+ *  contact@voidware.com
+ */
+
+#include <string.h>
+#include "defs.h"
+#include "kbd.h"
+#include "task.h"
+
+typedef struct
+{
+    TaskFn      fn;     // 0 if free
+    uchar       pri;    // higher first
+    uchar       budget; // slices per run
+} Task;
+
+// kept in priority order, free slots at the end
+static Task tasks[TASK_MAX];
+
+void taskInit()
+{
+    memset(tasks, 0, sizeof(tasks));
+}
+
+BOOL taskAdd(TaskFn fn, uchar pri, uchar budget)
+{
+    // return FALSE if full
+    
+    uchar i;
+    Task* t;
+
+    if (tasks[TASK_MAX-1].fn) return FALSE;
+
+    for (i = 0; i < TASK_MAX-1; ++i)
+        if (!tasks[i].fn || tasks[i].pri < pri) break;
+
+    t = tasks + i;
+    memmove(t + 1, t, (TASK_MAX-1 - i)*sizeof(Task));
+    t->fn = fn;
+    t->pri = pri;
+    t->budget = budget;
+    return TRUE;
+}
+
+void taskRemove(TaskFn fn)
+{
+    uchar i;
+    for (i = 0; i < TASK_MAX; ++i)
+    {
+        if (tasks[i].fn == fn)
+        {
+            memmove(tasks + i, tasks + i + 1, (TASK_MAX-1 - i)*sizeof(Task));
+            tasks[TASK_MAX-1].fn = 0;
+            break;
+        }
+    }
+}
+
+BOOL taskRun()
+{
+    // run tasks until they have no more work, spend their budget
+    // or a key is pressed. return TRUE if any did some work.
+    
+    uchar n;
+    BOOL busy = FALSE;
+    Task* t = tasks;
+
+    while (t < tasks + TASK_MAX && t->fn)
+    {
+        n = t->budget;
+        while (n && (*t->fn)())
+        {
+            busy = TRUE;
+            if (kbdWaiting()) return busy;
+            --n;
+        }
+        ++t;
+    }
+    return busy;
+}
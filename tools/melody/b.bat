@@ -0,0 +1,2 @@
+cl /EHsc melody.cpp
+rm *.obj
@@ -0,0 +1,223 @@
+/**
+ * Copyright (c) 2018 Voidware Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* melody compiler.
+ *
+ * reads lines of `name melody' and emits each melody as an array of
+ * notes ready for `playMelody' (see src/sound.h), so the game has no
+ * parsing or arithmetic to do between notes.
+ *
+ * a melody is:
+ *   [A-G][#b]?[0-9]*   note and its length, the length sticks
+ *   +  -               up or down an octave
+ *   <n>t               tempo divider, default 12
+ * as for the old `playNotes', an octave or tempo change applies from
+ * the note before it.
+ *
+ * each note is { cycles, 125*65536/f }, the game scales the second to
+ * a period for its measured clock. the array ends with { 0, 0 }.
+ * blank lines and lines starting with # are ignored.
+ *
+ * usage: melody melodies.txt [melodies.h]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+struct Note
+{
+    unsigned int        cycles;
+    unsigned int        pscale;
+};
+
+struct Melody
+{
+    std::string         name;
+    std::vector<Note>   notes;
+};
+
+std::vector<Melody>     melodies;
+
+// C C# D D# E F F# G G# A A# B
+static const char noteNames[] = "CCDDEFFGGAAB";
+
+static double noteFreq(int k)
+{
+    // semitones from middle C, "A" above it is 440Hz
+    return 440*pow(2.0, (k - 9)/12.0);
+}
+
+static bool addNote(Melody& m, int k, int u, int dt, int tempo)
+{
+    double f = noteFreq(k)*pow(2.0, u);
+    double c = f*dt/tempo;
+    double p = 125*65536.0/f;
+
+    if (c >= 65536 || p >= 65536 || c < 1)
+    {
+        fprintf(stderr, "melody %s, note %d out of range\n",
+                m.name.c_str(), (int)m.notes.size() + 1);
+        return false;
+    }
+
+    Note n;
+    n.cycles = (unsigned int)(c + 0.5);
+    n.pscale = (unsigned int)(p + 0.5);
+    m.notes.push_back(n);
+    return true;
+}
+
+static bool compile(Melody& m, const char* s)
+{
+    // as `playNotes' did
+    int k = -1;
+    int dt = 2;
+    int dt2 = 0;
+    int tempo = 12;
+    int u = 0;
+
+    for (;;)
+    {
+        char c = *s++;
+
+        if ((c >= 'A' && c <= 'G') || !c)
+        {
+            if (k >= 0)
+            {
+                if (dt2)
+                {
+                    dt = dt2;
+                    dt2 = 0;
+                }
+                if (!addNote(m, k, u, dt, tempo)) return false;
+            }
+
+            if (!c) break;
+            k = strchr(noteNames, c) - noteNames;
+        }
+        else if (c == '#') ++k;
+        else if (c == 'b') --k;
+        else if (c == '+') ++u;
+        else if (c == '-') --u;
+        else if (isdigit((unsigned char)c)) dt2 = 10*dt2 + (c - '0');
+        else if (c == 't')
+        {
+            if (!dt2)
+            {
+                fprintf(stderr, "melody %s, zero tempo\n", m.name.c_str());
+                return false;
+            }
+            tempo = dt2;
+            dt2 = 0;
+        }
+        else if (!isspace((unsigned char)c))
+        {
+            fprintf(stderr, "melody %s, bad character '%c'\n",
+                    m.name.c_str(), c);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parse(FILE* fp)
+{
+    char line[1024];
+    while (fgets(line, sizeof(line), fp))
+    {
+        char* p = line;
+        while (isspace((unsigned char)*p)) ++p;
+        if (!*p || *p == '#') continue;
+
+        Melody m;
+        while (isalnum((unsigned char)*p) || *p == '_') m.name += *p++;
+        if (m.name.empty())
+        {
+            fprintf(stderr, "bad line: %s", line);
+            return false;
+        }
+
+        // rest of the line, without the newline
+        p[strcspn(p, "\r\n")] = 0;
+        if (!compile(m, p)) return false;
+        melodies.push_back(m);
+    }
+    return true;
+}
+
+static void emit(FILE* fp, const char* src)
+{
+    fprintf(fp, "/* generated by tools/melody from %s. do not edit */\n\n", src);
+
+    for (size_t i = 0; i < melodies.size(); ++i)
+    {
+        const Melody& m = melodies[i];
+
+        fprintf(fp, "static const MelodyNote %s[] =\n{\n", m.name.c_str());
+        for (size_t j = 0; j < m.notes.size(); ++j)
+            fprintf(fp, "    { %u, %u },\n",
+                    m.notes[j].cycles, m.notes[j].pscale);
+        fprintf(fp, "    { 0, 0 },\n};\n\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("usage: %s melodies.txt [melodies.h]\n", argv[0]);
+        return 1;
+    }
+
+    const char* infile = argv[1];
+    FILE* in = fopen(infile, "r");
+    if (!in)
+    {
+        fprintf(stderr, "can't open %s\n", infile);
+        return 1;
+    }
+
+    bool ok = parse(in);
+    fclose(in);
+    if (!ok) return 1;
+
+    FILE* fp = stdout;
+    if (argc > 2)
+    {
+        fp = fopen(argv[2], "w");
+        if (!fp)
+        {
+            fprintf(stderr, "can't write %s\n", argv[2]);
+            return 1;
+        }
+    }
+
+    emit(fp, infile);
+
+    if (fp != stdout) fclose(fp);
+    return 0;
+}
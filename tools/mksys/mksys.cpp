@@ -23,6 +23,7 @@
 /* program to convert intel HEX binary to TRS80 SYSTEM CAS */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "cutils.h"
 #include <vector>
@@ -32,6 +33,12 @@ int verbose = 0;
 // XXX
 #define PROG_NAME "APSH18"
 
+const char* progName = PROG_NAME;
+
+// only emit bytes in [rangeStart, rangeEnd), eg. an overlay
+int rangeStart = 0;
+int rangeEnd = 0x10000;
+
 const char* readline(FILE* fp)
 {
     static char buf[256];
@@ -149,7 +156,7 @@ void emitFile(FILE* fpout)
     size_t n = blocks.size();
     if (!n) return; // bail
 
-    cas_write_header(fpout, PROG_NAME);
+    cas_write_header(fpout, (char*)progName);
 
     int startAddr = 0;
     bool more;
@@ -260,9 +267,26 @@ void processFile(FILE* fpin, FILE* fpout)
             *pb++ = v;
         }
 
+        // clip to range
+        unsigned char* pd = buf;
+        int end = b->addr + b->size;
+        if (b->addr < rangeStart)
+        {
+            pd += rangeStart - b->addr;
+            b->addr = rangeStart;
+        }
+        if (end > rangeEnd) end = rangeEnd;
+
+        if (end <= b->addr)
+        {
+            delete b;
+            continue;
+        }
+        b->size = end - b->addr;
+
         // copy data into the block
-        b->data = new unsigned char[pb - buf];
-        memcpy(b->data, buf, pb - buf);
+        b->data = new unsigned char[b->size];
+        memcpy(b->data, pd, b->size);
 
         blocks.push_back(b);
     }
@@ -283,6 +307,17 @@ int main(int argc, char** argv)
         if (argv[i][0] == '-')
         {
             if (!strcmp(argv[i], "-v")) verbose = 1;
+            else if (!strcmp(argv[i], "-n") && i < argc-1)
+            {
+                progName = argv[++i];
+            }
+            else if (!strcmp(argv[i], "-r") && i < argc-1)
+            {
+                // start,length
+                char* e;
+                rangeStart = strtol(argv[++i], &e, 0);
+                if (*e == ',') rangeEnd = rangeStart + strtol(e + 1, 0, 0);
+            }
         }
         else
         {
@@ -295,7 +330,7 @@ int main(int argc, char** argv)
 
     if (!infile || !outfile)
     {
-        printf("usage: %s [-v] <infile> <outfile>\n", argv[0]);
+        printf("usage: %s [-v] [-n name] [-r start,length] <infile> <outfile>\n", argv[0]);
         return 1;
     }
 
@@ -0,0 +1,2 @@
+cl /EHsc prof.cpp
+rm *.obj
@@ -0,0 +1,259 @@
+/**
+ * Copyright (c) 2018 Voidware Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* profile reader.
+ *
+ * reads the page histogram written by a PROFILE build (see
+ * src/prof.h), 256 little endian 16 bit counts of samples whose PC
+ * was in that 256 byte page, and shares each page out over the
+ * functions in it by the bytes they cover, using the symbols of the
+ * linker's NoICE file.
+ *
+ * only symbols inside the code areas (_CODE, _GEN, _HOME, _GSINIT)
+ * count, samples elsewhere are ROM, DOS or data and are shown by page.
+ *
+ * usage: prof [-p] apshai18.noi prof.dat
+ *   -p  also list the raw page counts
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+struct Sym
+{
+    std::string         name;
+    unsigned int        addr;
+    unsigned int        end;
+    double              samples;
+};
+
+struct Area
+{
+    std::string         name;
+    unsigned int        start;
+    unsigned int        size;
+};
+
+static std::vector<Sym>     syms;
+static std::vector<Area>    areas;
+
+static const char* codeAreas[] = { "CODE", "GEN", "HOME", "GSINIT", 0 };
+
+static bool isCodeArea(const std::string& n)
+{
+    for (const char** p = codeAreas; *p; ++p)
+        if (n == *p) return true;
+    return false;
+}
+
+static Area* findArea(const std::string& n)
+{
+    for (size_t i = 0; i < areas.size(); ++i)
+        if (areas[i].name == n) return &areas[i];
+
+    Area a;
+    a.name = n;
+    a.start = a.size = 0;
+    areas.push_back(a);
+    return &areas.back();
+}
+
+static bool inCode(unsigned int a)
+{
+    for (size_t i = 0; i < areas.size(); ++i)
+    {
+        const Area& ar = areas[i];
+        if (isCodeArea(ar.name) && a >= ar.start && a < ar.start + ar.size)
+            return true;
+    }
+    return false;
+}
+
+static bool readNoi(const char* file)
+{
+    // lines are `DEF name 0xADDR', areas as s__NAME and l__NAME
+    FILE* fp = fopen(file, "r");
+    if (!fp) return false;
+
+    char line[256];
+    char name[128];
+    std::vector<Sym> all;
+
+    while (fgets(line, sizeof(line), fp))
+    {
+        unsigned int v;
+        if (sscanf(line, "DEF %127s %x", name, &v) != 2) continue;
+
+        if (!strncmp(name, "s__", 3)) findArea(name + 3)->start = v;
+        else if (!strncmp(name, "l__", 3)) findArea(name + 3)->size = v;
+        else
+        {
+            Sym s;
+            s.name = name;
+            s.addr = v;
+            s.end = 0;
+            s.samples = 0;
+            all.push_back(s);
+        }
+    }
+    fclose(fp);
+
+    for (size_t i = 0; i < all.size(); ++i)
+        if (inCode(all[i].addr)) syms.push_back(all[i]);
+
+    std::sort(syms.begin(), syms.end(),
+              [](const Sym& a, const Sym& b) { return a.addr < b.addr; });
+
+    // each function runs to the next symbol or the end of its area
+    for (size_t i = 0; i < syms.size(); ++i)
+    {
+        unsigned int e = 0x10000;
+        for (size_t j = 0; j < areas.size(); ++j)
+        {
+            const Area& ar = areas[j];
+            unsigned int ae = ar.start + ar.size;
+            if (syms[i].addr >= ar.start && syms[i].addr < ae) e = ae;
+        }
+        if (i + 1 < syms.size() && syms[i+1].addr < e) e = syms[i+1].addr;
+        syms[i].end = e;
+    }
+    return !syms.empty();
+}
+
+static bool readHist(const char* file, unsigned int* hist)
+{
+    FILE* fp = fopen(file, "rb");
+    if (!fp) return false;
+
+    unsigned char buf[512];
+    size_t n = fread(buf, 1, sizeof(buf), fp);
+    fclose(fp);
+    if (n != sizeof(buf)) return false;
+
+    for (int i = 0; i < 256; ++i) hist[i] = buf[i*2] | (buf[i*2+1] << 8);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const char* noifile = 0;
+    const char* datfile = 0;
+    bool pages = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-p")) pages = true;
+        else if (!noifile) noifile = argv[i];
+        else datfile = argv[i];
+    }
+
+    if (!noifile || !datfile)
+    {
+        printf("usage: %s [-p] apshai18.noi prof.dat\n", argv[0]);
+        return 1;
+    }
+
+    if (!readNoi(noifile))
+    {
+        fprintf(stderr, "can't read code symbols from %s\n", noifile);
+        return 1;
+    }
+
+    unsigned int hist[256];
+    if (!readHist(datfile, hist))
+    {
+        fprintf(stderr, "can't read %s\n", datfile);
+        return 1;
+    }
+
+    unsigned long total = 0;
+    unsigned long other = 0;
+    std::vector<int> otherPages;
+
+    for (unsigned int p = 0; p < 256; ++p)
+    {
+        if (!hist[p]) continue;
+        total += hist[p];
+
+        unsigned int a = p << 8;
+        unsigned int b = a + 256;
+        unsigned int covered = 0;
+
+        for (size_t i = 0; i < syms.size(); ++i)
+        {
+            Sym& s = syms[i];
+            unsigned int lo = std::max(a, s.addr);
+            unsigned int hi = std::min(b, s.end);
+            if (lo < hi)
+            {
+                s.samples += hist[p]*(double)(hi - lo)/256;
+                covered += hi - lo;
+            }
+        }
+
+        if (covered < 256)
+        {
+            other += hist[p]*(256 - covered)/256;
+            otherPages.push_back(p);
+        }
+    }
+
+    if (!total)
+    {
+        printf("no samples\n");
+        return 0;
+    }
+
+    std::vector<Sym> byCount = syms;
+    std::sort(byCount.begin(), byCount.end(),
+              [](const Sym& a, const Sym& b) { return a.samples > b.samples; });
+
+    printf("%lu samples\n\n", total);
+    for (size_t i = 0; i < byCount.size(); ++i)
+    {
+        const Sym& s = byCount[i];
+        if (s.samples < 0.5) break;
+        printf("%8.0f %5.1f%%  %04X %s\n",
+               s.samples, 100*s.samples/total, s.addr, s.name.c_str());
+    }
+
+    if (other)
+    {
+        printf("%8lu %5.1f%%  outside the program, pages",
+               other, 100.0*other/total);
+        for (size_t i = 0; i < otherPages.size(); ++i)
+            printf(" %02X", otherPages[i]);
+        printf("\n");
+    }
+
+    if (pages)
+    {
+        printf("\npage  samples\n");
+        for (unsigned int p = 0; p < 256; ++p)
+            if (hist[p]) printf("  %02X %8u\n", p, hist[p]);
+    }
+    return 0;
+}
@@ -0,0 +1,2 @@
+cl /EHsc sprc.cpp
+rm *.obj
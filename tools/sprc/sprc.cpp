@@ -0,0 +1,324 @@
+/**
+ * Copyright (c) 2018 Voidware Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* sprite compiler.
+ *
+ * reads the RLE sprites of `sprdef.h' and emits pre-shifted cell
+ * images for each of the 6 pixel phases of a TRS-80 semigraphic cell
+ * (x&1 times y%3).
+ *
+ * each image is: <w> <h> then w*h cell masks, row by row.
+ * SPRITE_CELLS is the most cells of any image, which the compositor
+ * must have room to save (see SPRITE_SAVE in plot.h).
+ * a cell mask has the usual TRS-80 layout,
+ *
+ *  0x01 0x02
+ *  0x04 0x08
+ *  0x10 0x20
+ *
+ * usage: sprc sprdef.h sprites.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+#include <vector>
+
+int verbose = 0;
+
+struct Pixel
+{
+    int x;
+    int y;
+};
+
+struct Sprite
+{
+    Sprite() { ox = oy = 0; }
+
+    std::string                 name;
+    std::vector<int>            rle;
+    std::vector<Pixel>          pix;
+    int                         ox;
+    int                         oy;
+};
+
+std::vector<Sprite*>    sprites;
+
+static char* readFile(const char* name)
+{
+    FILE* fp = fopen(name, "rb");
+    if (!fp) return 0;
+
+    fseek(fp, 0, SEEK_END);
+    long n = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    char* buf = new char[n + 1];
+    n = fread(buf, 1, n, fp);
+    buf[n] = 0;
+    fclose(fp);
+    return buf;
+}
+
+static const char* skipSpace(const char* p)
+{
+    while (*p && isspace((unsigned char)*p)) ++p;
+    return p;
+}
+
+static const char* getIdent(const char* p, std::string& s)
+{
+    s.clear();
+    while (isalnum((unsigned char)*p) || *p == '_') s += *p++;
+    return p;
+}
+
+static bool getOrigin(const char* text, Sprite* sp)
+{
+    // look for #define NAME_ORIGIN x,y
+    std::string key = "#define " + sp->name + "_ORIGIN";
+    const char* p = strstr(text, key.c_str());
+    if (!p) return false;
+
+    char* e;
+    p += key.size();
+    sp->ox = strtol(p, &e, 0);
+    p = skipSpace(e);
+    if (*p != ',') return false;
+    sp->oy = strtol(p + 1, &e, 0);
+    return true;
+}
+
+static bool parse(const char* text)
+{
+    // find each `static const uchar NAME[] = { ... };'
+
+    const char* key = "static const uchar";
+    const char* p = text;
+
+    while ((p = strstr(p, key)) != 0)
+    {
+        p = skipSpace(p + strlen(key));
+
+        Sprite* sp = new Sprite;
+        p = getIdent(p, sp->name);
+
+        p = strchr(p, '{');
+        if (!p) return false;
+        ++p;
+
+        for (;;)
+        {
+            p = skipSpace(p);
+            if (*p == ',') { ++p; continue; }
+            if (*p == '}' || !*p) break;
+
+            char* e;
+            long v = strtol(p, &e, 0);
+            if (e == p)
+            {
+                fprintf(stderr, "bad data in sprite %s\n", sp->name.c_str());
+                return false;
+            }
+            sp->rle.push_back((int)v);
+            p = e;
+        }
+
+        if (!getOrigin(text, sp))
+        {
+            fprintf(stderr, "warning: sprite %s has no origin\n",
+                    sp->name.c_str());
+        }
+
+        sprites.push_back(sp);
+    }
+    return true;
+}
+
+static void decode(Sprite* sp)
+{
+    // same as `pixelsRLE'
+    int x = 0;
+    int y = 0;
+    size_t i = 0;
+    size_t n = sp->rle.size();
+
+    for (;;)
+    {
+        int pair;
+        while (i < n && (pair = sp->rle[i++]) != 0)
+        {
+            x += pair >> 4; // skip
+            pair &= 0xf;
+            while (pair--)
+            {
+                Pixel p;
+                p.x = x++;
+                p.y = y;
+                sp->pix.push_back(p);
+            }
+        }
+
+        // flyback
+        if (i >= n || !sp->rle[i]) break;
+        x -= sp->rle[i++];
+        ++y;
+    }
+
+    // flyback can take the sprite left of its first pixel. normalise
+    // so that all pixels are >= 0 and move the origin to suit.
+    int minx = 0;
+    int miny = 0;
+    for (i = 0; i < sp->pix.size(); ++i)
+    {
+        if (sp->pix[i].x < minx) minx = sp->pix[i].x;
+        if (sp->pix[i].y < miny) miny = sp->pix[i].y;
+    }
+
+    for (i = 0; i < sp->pix.size(); ++i)
+    {
+        sp->pix[i].x -= minx;
+        sp->pix[i].y -= miny;
+    }
+
+    sp->ox += minx;
+    sp->oy += miny;
+
+    if (verbose)
+        printf("sprite %s, %d pixels\n", sp->name.c_str(), (int)sp->pix.size());
+}
+
+static int emitImage(FILE* fp, Sprite* sp, int phase)
+{
+    // return the number of cells
+    // phase = (y%3)*2 + (x&1) of the top left pixel
+    int dx = phase & 1;
+    int dy = phase >> 1;
+
+    int w = 0;
+    int h = 0;
+    size_t i;
+
+    for (i = 0; i < sp->pix.size(); ++i)
+    {
+        int cx = (sp->pix[i].x + dx) >> 1;
+        int cy = (sp->pix[i].y + dy) / 3;
+        if (cx >= w) w = cx + 1;
+        if (cy >= h) h = cy + 1;
+    }
+
+    std::vector<int> cells(w*h);
+    for (i = 0; i < sp->pix.size(); ++i)
+    {
+        int x = sp->pix[i].x + dx;
+        int y = sp->pix[i].y + dy;
+        cells[(y/3)*w + (x>>1)] |= 1 << ((y % 3)*2 + (x & 1));
+    }
+
+    fprintf(fp, "static const uchar %s_%d[] = { %d,%d,",
+            sp->name.c_str(), phase, w, h);
+
+    for (i = 0; i < cells.size(); ++i)
+        fprintf(fp, " 0x%02X,", cells[i]);
+
+    fprintf(fp, " };\n");
+    return w*h;
+}
+
+static void emit(FILE* fp, const char* src)
+{
+    int cells = 0;
+    
+    fprintf(fp, "/* generated by tools/sprc from %s. do not edit */\n\n", src);
+
+    for (size_t i = 0; i < sprites.size(); ++i)
+    {
+        Sprite* sp = sprites[i];
+        int j;
+        int n;
+
+        for (j = 0; j < 6; ++j)
+        {
+            n = emitImage(fp, sp, j);
+            if (n > cells) cells = n;
+        }
+
+        fprintf(fp, "\nstatic const CSprite %s = { %d, %d, {",
+                sp->name.c_str(), sp->ox, sp->oy);
+
+        for (j = 0; j < 6; ++j)
+            fprintf(fp, " %s_%d,", sp->name.c_str(), j);
+        fprintf(fp, " } };\n\n");
+    }
+
+    fprintf(fp, "#define SPRITE_CELLS %d\n", cells);
+}
+
+int main(int argc, char** argv)
+{
+    const char* infile = 0;
+    const char* outfile = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-v")) verbose = 1;
+        else if (!infile) infile = argv[i];
+        else outfile = argv[i];
+    }
+
+    if (!infile)
+    {
+        printf("usage: %s [-v] sprdef.h [sprites.h]\n", argv[0]);
+        return 1;
+    }
+
+    char* text = readFile(infile);
+    if (!text)
+    {
+        fprintf(stderr, "can't open %s\n", infile);
+        return 1;
+    }
+
+    if (!parse(text)) return 1;
+
+    for (size_t i = 0; i < sprites.size(); ++i) decode(sprites[i]);
+
+    FILE* fp = stdout;
+    if (outfile)
+    {
+        fp = fopen(outfile, "w");
+        if (!fp)
+        {
+            fprintf(stderr, "can't write %s\n", outfile);
+            return 1;
+        }
+    }
+
+    emit(fp, infile);
+
+    if (fp != stdout) fclose(fp);
+    delete [] text;
+    return 0;
+}